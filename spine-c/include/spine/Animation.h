@@ -41,6 +41,7 @@ extern "C" {
 
 typedef struct spTimeline spTimeline;
 struct spSkeleton;
+struct spSkeletonData;
 
 typedef struct spAnimation {
 	const char* const name;
@@ -49,12 +50,24 @@ typedef struct spAnimation {
 	int timelinesCount;
 	spTimeline** timelines;
 
+	/* Bitset of the properties this animation replaces when applied with full alpha, because a timeline keys them from time 0.
+	 * Each bone has 3 bits (rotation, translation, scale), followed by a bit for each slot's color and each IK constraint.
+	 * 0 until spAnimation_updateMasks is called. */
+	unsigned int* const replaceMask;
+	/* Indices of the timelines that have a bit in replaceMask, ordered by that bit, so the timelines of two animations that
+	 * key the same property can be paired in one pass. 0 until spAnimation_updateMasks is called. */
+	int maskedTimelinesCount;
+	int* const maskedTimelines;
+
 #ifdef __cplusplus
 	spAnimation() :
 		name(0),
 		duration(0),
 		timelinesCount(0),
-		timelines(0) {
+		timelines(0),
+		replaceMask(0),
+		maskedTimelinesCount(0),
+		maskedTimelines(0) {
 	}
 #endif
 } spAnimation;
@@ -62,6 +75,27 @@ typedef struct spAnimation {
 spAnimation* spAnimation_create (const char* name, int timelinesCount);
 void spAnimation_dispose (spAnimation* self);
 
+/** Computes the replace mask and the masked timelines order. Must be called if timelines are added or changed. */
+void spAnimation_updateMasks (spAnimation* self, const struct spSkeletonData* skeletonData);
+
+/** Removes keys the timeline's interpolation reproduces within tolerance: keys on the line between their neighbors, repeated
+ * values and trailing keys that don't change the value. Timelines left with a single key are applied as constants. If
+ * removeSetupPose is true, timelines that only key the setup pose are removed. This is not lossless when the animation is
+ * mixed with others, since those timelines return their properties to the setup pose. Rotate, translate, scale, color and IK
+ * constraint timelines are reduced. */
+void spAnimation_reduceKeys (spAnimation* self, const struct spSkeletonData* skeletonData, float tolerance,
+		int/*bool*/removeSetupPose);
+
+/** Stores the keys of rotate, translate, scale and color timelines in less memory: times and values as 16 bit steps across
+ * their range in the timeline, colors as 8 bit steps. A timeline is only quantized if all its keys stay within the error
+ * given for its type and for times, and a negative error keeps those timelines as floats. Quantized timelines have no frames
+ * and are decoded when applied. Their setFrame functions and spSkeletonData_foldStaticBones decode the keys back into frames
+ * first, so call this after passes that change keys to keep the savings. */
+void spAnimation_quantize (spAnimation* self, float timeError, float rotateError, float translateError, float scaleError,
+		float colorError);
+/** Decodes the keys of quantized timelines back into frames, so code that reads frames can be used. */
+void spAnimation_dequantize (spAnimation* self);
+
 /** Poses the skeleton at the specified time for this animation.
  * @param lastTime The last time the animation was applied.
  * @param events Any triggered events are added. */
@@ -79,6 +113,10 @@ void spAnimation_mix (const spAnimation* self, struct spSkeleton* skeleton, floa
 typedef spAnimation Animation;
 #define Animation_create(...) spAnimation_create(__VA_ARGS__)
 #define Animation_dispose(...) spAnimation_dispose(__VA_ARGS__)
+#define Animation_updateMasks(...) spAnimation_updateMasks(__VA_ARGS__)
+#define Animation_reduceKeys(...) spAnimation_reduceKeys(__VA_ARGS__)
+#define Animation_quantize(...) spAnimation_quantize(__VA_ARGS__)
+#define Animation_dequantize(...) spAnimation_dequantize(__VA_ARGS__)
 #define Animation_apply(...) spAnimation_apply(__VA_ARGS__)
 #define Animation_mix(...) spAnimation_mix(__VA_ARGS__)
 #endif
@@ -133,11 +171,14 @@ typedef spTimeline Timeline;
 typedef struct spCurveTimeline {
 	spTimeline super;
 	float* curves; /* type, x, y, ... */
+	/* The keys stored by spAnimation_quantize instead of the frames, which are then 0, see spAnimation_dequantize. */
+	const void* const quantized;
 
 #ifdef __cplusplus
 	spCurveTimeline() :
 		super(),
-		curves(0) {
+		curves(0),
+		quantized(0) {
 	}
 #endif
 } spCurveTimeline;
@@ -343,7 +384,13 @@ typedef struct spFFDTimeline {
 	int const framesCount;
 	float* const frames; /* time, ... */
 	int const frameVerticesCount;
+	/* For each frame, frameCounts values starting at frameOffsets, relative to the attachment's setup vertices. Other vertices
+	 * are the setup vertices. */
 	const float** const frameVertices;
+	const int* const frameOffsets;
+	const int* const frameCounts;
+	/* The range of vertices any frame changes. */
+	int const keyedStart, keyedEnd;
 	int slotIndex;
 	spAttachment* attachment;
 
@@ -354,19 +401,29 @@ typedef struct spFFDTimeline {
 		frames(0),
 		frameVerticesCount(0),
 		frameVertices(0),
-		slotIndex(0) {
+		frameOffsets(0),
+		frameCounts(0),
+		keyedStart(0), keyedEnd(0),
+		slotIndex(0),
+		attachment(0) {
 	}
 #endif
 } spFFDTimeline;
 
 spFFDTimeline* spFFDTimeline_create (int framesCount, int frameVerticesCount);
 
+/* Sets a frame from all the vertices. The attachment must be set first, the frame only stores where they differ from its setup
+ * vertices. */
 void spFFDTimeline_setFrame (spFFDTimeline* self, int frameIndex, float time, float* vertices);
+/* Sets a frame from the offsets to the attachment's setup vertices, for count vertex values starting at offset. */
+void spFFDTimeline_setSparseFrame (spFFDTimeline* self, int frameIndex, float time, int offset, int count,
+		const float* vertexOffsets);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spFFDTimeline FFDTimeline;
 #define FFDTimeline_create(...) spFFDTimeline_create(__VA_ARGS__)
 #define FFDTimeline_setFrame(...) spFFDTimeline_setFrame(__VA_ARGS__)
+#define FFDTimeline_setSparseFrame(...) spFFDTimeline_setSparseFrame(__VA_ARGS__)
 #endif
 
 /**/
@@ -59,6 +59,9 @@ struct spTrackEntry {
 	float delay, time, lastTime, endTime, timeScale;
 	spAnimationStateListener listener;
 	float mixTime, mixDuration, mix;
+	/* If not 0, only the bones whose index bit is set (bonesMask[index >> 5] & (1u << (index & 31))) are posed by this entry's
+	 * bone timelines. Not owned by the entry. */
+	const unsigned int* bonesMask;
 
 	void* rendererObject;
 
@@ -72,6 +75,7 @@ struct spTrackEntry {
 		delay(0), time(0), lastTime(0), endTime(0), timeScale(0),
 		listener(0),
 		mixTime(0), mixDuration(0), mix(0),
+		bonesMask(0),
 		rendererObject(0) {
 	}
 #endif
@@ -81,6 +85,9 @@ struct spAnimationState {
 	spAnimationStateData* const data;
 	float timeScale;
 	spAnimationStateListener listener;
+	/* When true, the EVENT and COMPLETE listener calls from apply are queued and made after all tracks are applied, instead
+	 * of between timelines. START and END are not deferred. */
+	int/*bool*/deferEvents;
 
 	int tracksCount;
 	spTrackEntry** tracks;
@@ -92,6 +99,7 @@ struct spAnimationState {
 		data(0),
 		timeScale(0),
 		listener(0),
+		deferEvents(0),
 		tracksCount(0),
 		tracks(0),
 		rendererObject(0) {
@@ -103,6 +111,10 @@ struct spAnimationState {
 spAnimationState* spAnimationState_create (spAnimationStateData* data);
 void spAnimationState_dispose (spAnimationState* self);
 
+/** Allocates the tracks, adds track entries to the pool that set and add take entries from, and sizes the event buffers
+ * for the skeleton data's animations, so a warmed up state does not allocate. */
+void spAnimationState_preallocate (spAnimationState* self, int tracksCount, int trackEntriesCount);
+
 void spAnimationState_update (spAnimationState* self, float delta);
 void spAnimationState_apply (spAnimationState* self, struct spSkeleton* skeleton);
 
@@ -134,6 +146,7 @@ typedef spTrackEntry TrackEntry;
 typedef spAnimationState AnimationState;
 #define AnimationState_create(...) spAnimationState_create(__VA_ARGS__)
 #define AnimationState_dispose(...) spAnimationState_dispose(__VA_ARGS__)
+#define AnimationState_preallocate(...) spAnimationState_preallocate(__VA_ARGS__)
 #define AnimationState_update(...) spAnimationState_update(__VA_ARGS__)
 #define AnimationState_apply(...) spAnimationState_apply(__VA_ARGS__)
 #define AnimationState_clearTracks(...) spAnimationState_clearTracks(__VA_ARGS__)
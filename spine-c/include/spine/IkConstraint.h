@@ -68,6 +68,11 @@ void spIkConstraint_dispose (spIkConstraint* self);
 
 void spIkConstraint_apply (spIkConstraint* self);
 
+/* Same as spIkConstraint_apply for each constraint, with the same results. The constraints must not constrain bones another
+ * of them reads, as with the same constraint of many skeletons. The inputs of the constraints are gathered into arrays and
+ * each step of the solvers is run for all of them in turn. */
+void spIkConstraint_applyBatch (spIkConstraint** constraints, int count);
+
 void spIkConstraint_apply1 (spBone* bone, float targetX, float targetY, float alpha);
 void spIkConstraint_apply2 (spBone* parent, spBone* child, float targetX, float targetY, int bendDirection, float alpha);
 
@@ -75,6 +80,8 @@ void spIkConstraint_apply2 (spBone* parent, spBone* child, float targetX, float
 typedef spIkConstraint IkConstraint;
 #define IkConstraint_create(...) spIkConstraint_create(__VA_ARGS__)
 #define IkConstraint_dispose(...) spIkConstraint_dispose(__VA_ARGS__)
+#define IkConstraint_apply(...) spIkConstraint_apply(__VA_ARGS__)
+#define IkConstraint_applyBatch(...) spIkConstraint_applyBatch(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -55,6 +55,7 @@ typedef struct spMeshAttachment {
 	int* triangles;
 
 	float r, g, b, a;
+	float radius; /* Largest distance of a vertex from the bone origin, in bone space. Set by updateBounds, 0 if unknown. */
 
 	void* rendererObject;
 	int regionOffsetX, regionOffsetY; /* Pixels stripped from the bottom left, unrotated. */
@@ -71,12 +72,15 @@ typedef struct spMeshAttachment {
 
 spMeshAttachment* spMeshAttachment_create (const char* name);
 void spMeshAttachment_updateUVs (spMeshAttachment* self);
+/* Computes the radius. Call after changing the vertices, otherwise spSlot_getBounds measures the vertices each time. */
+void spMeshAttachment_updateBounds (spMeshAttachment* self);
 void spMeshAttachment_computeWorldVertices (spMeshAttachment* self, spSlot* slot, float* worldVertices);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spMeshAttachment MeshAttachment;
 #define MeshAttachment_create(...) spMeshAttachment_create(__VA_ARGS__)
 #define MeshAttachment_updateUVs(...) spMeshAttachment_updateUVs(__VA_ARGS__)
+#define MeshAttachment_updateBounds(...) spMeshAttachment_updateBounds(__VA_ARGS__)
 #define MeshAttachment_computeWorldVertices(...) spMeshAttachment_computeWorldVertices(__VA_ARGS__)
 #endif
 
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_POSEGROUP_H_
+#define SPINE_POSEGROUP_H_
+
+#include <spine/AnimationState.h>
+#include <spine/Skeleton.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shares poses between skeletons of the same skeleton data playing the same animations at the same time, such as a crowd.
+ * The first skeleton applied with a given key is posed by its animation state, the others with the same key copy its bone
+ * transforms, slot state, draw order and IK constraints instead of evaluating timelines and world transforms. The key is the
+ * skeleton's skin, flips and live bones and, for each track, the animations, times, loop, mix and bone mask. The skeleton
+ * position and color are not part of the pose, so each skeleton is still drawn at its own position and tint.
+ *
+ * Skeletons sharing a key are assumed to have the same pose history, as when they were started together. Attachments and
+ * bones not keyed by the current animations keep whatever the source skeleton had. */
+typedef struct spPoseGroup {
+	/* The number of skeletons posed by their animation state and by copying a pose since the last clear. */
+	const int evaluatedCount;
+	const int sharedCount;
+} spPoseGroup;
+
+spPoseGroup* spPoseGroup_create ();
+void spPoseGroup_dispose (spPoseGroup* self);
+
+/** Forgets the poses applied so far. Call once per frame, before the skeletons are applied. */
+void spPoseGroup_clear (spPoseGroup* self);
+
+/** Same as spAnimationState_apply followed by spSkeleton_updateWorldTransform, except that if a skeleton with the same key
+ * was applied since the last clear, its pose is copied. The state still fires its own events either way. The source
+ * skeleton must not be changed or disposed until the next clear. */
+void spPoseGroup_apply (spPoseGroup* self, spAnimationState* state, spSkeleton* skeleton);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spPoseGroup PoseGroup;
+#define PoseGroup_create(...) spPoseGroup_create(__VA_ARGS__)
+#define PoseGroup_dispose(...) spPoseGroup_dispose(__VA_ARGS__)
+#define PoseGroup_clear(...) spPoseGroup_clear(__VA_ARGS__)
+#define PoseGroup_apply(...) spPoseGroup_apply(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_POSEGROUP_H_ */
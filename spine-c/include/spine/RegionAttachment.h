@@ -57,6 +57,7 @@ typedef struct spRegionAttachment {
 
 	float offset[8];
 	float uvs[8];
+	float radius; /* Largest distance of a corner from the bone origin, in bone space. Set by updateOffset. */
 } spRegionAttachment;
 
 spRegionAttachment* spRegionAttachment_create (const char* name);
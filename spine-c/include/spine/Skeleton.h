@@ -44,6 +44,9 @@ extern "C" {
 typedef struct spSkeleton {
 	spSkeletonData* const data;
 
+	/* The bones and slots each live in one contiguous block, in skeleton data order, so walking them in order has a fixed
+	 * stride. Their pose fields stay in spBone and spSlot rather than in separate per-field arrays, so code using those fields
+	 * directly keeps working. */
 	int bonesCount;
 	spBone** bones;
 	spBone* const root;
@@ -61,6 +64,9 @@ typedef struct spSkeleton {
 	int/*bool*/flipX, flipY;
 	float x, y;
 
+	/* A bit per bone, set for bones that are updated, or 0 to update all bones. See spSkeleton_updateLiveBones. */
+	unsigned int* const liveBones;
+
 #ifdef __cplusplus
 	spSkeleton() :
 		data(0),
@@ -79,7 +85,8 @@ typedef struct spSkeleton {
 		time(0),
 		flipX(0),
 		flipY(0),
-		x(0), y(0) {
+		x(0), y(0),
+		liveBones(0) {
 	}
 #endif
 } spSkeleton;
@@ -87,10 +94,25 @@ typedef struct spSkeleton {
 spSkeleton* spSkeleton_create (spSkeletonData* data);
 void spSkeleton_dispose (spSkeleton* self);
 
-/* Caches information about bones and IK constraints. Must be called if bones or IK constraints are added or removed. */
+/* Same as spSkeletonData_updateCache for the skeleton's data. The cache is shared, so this must not be called while any
+ * skeleton of the data is being updated or drawn, for example by spSkeletonBatch or other threads. */
 void spSkeleton_updateCache (const spSkeleton* self);
+
+/* Allocates each slot's attachment vertices for the largest FFD keys in the skeleton data's animations and the slot's world
+ * vertices cache for its largest attachment in any skin, so applying animations and computing vertices don't allocate. */
+void spSkeleton_preallocate (spSkeleton* self);
+
 void spSkeleton_updateWorldTransform (const spSkeleton* self);
 
+/* Restricts bone timelines and spSkeleton_updateWorldTransform to the bones something needs, so unused helper and control bones
+ * cost nothing. Those are the given bones, the bones of bounding boxes and, if drawn is true, of drawn attachments, in the
+ * skeleton's skin, the default skin or attached to a slot, the bones and targets of IK constraints that constrain any of these,
+ * and their ancestors. Other bones keep stale world transforms. Recomputed by spSkeleton_setSkin, call again if the bones needed
+ * change or an attachment from elsewhere is attached. */
+void spSkeleton_updateLiveBones (spSkeleton* self, int/*bool*/drawn, spBone** bones, int bonesCount);
+/* Updates all bones again. */
+void spSkeleton_clearLiveBones (spSkeleton* self);
+
 void spSkeleton_setToSetupPose (const spSkeleton* self);
 void spSkeleton_setBonesToSetupPose (const spSkeleton* self);
 void spSkeleton_setSlotsToSetupPose (const spSkeleton* self);
@@ -127,11 +149,19 @@ spIkConstraint* spSkeleton_findIkConstraint (const spSkeleton* self, const char*
 
 void spSkeleton_update (spSkeleton* self, float deltaTime);
 
+/* Computes a conservative axis aligned bounding box of all attachments in world coordinates, see spSlot_getBounds. This is
+ * much cheaper than computing the vertices. Returns false if no slot has a region or mesh attachment.
+ * @param bounds minX, minY, maxX, maxY. */
+int/*bool*/spSkeleton_getBounds (const spSkeleton* self, float* bounds);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeleton Skeleton;
 #define Skeleton_create(...) spSkeleton_create(__VA_ARGS__)
 #define Skeleton_dispose(...) spSkeleton_dispose(__VA_ARGS__)
+#define Skeleton_preallocate(...) spSkeleton_preallocate(__VA_ARGS__)
 #define Skeleton_updateWorldTransform(...) spSkeleton_updateWorldTransform(__VA_ARGS__)
+#define Skeleton_updateLiveBones(...) spSkeleton_updateLiveBones(__VA_ARGS__)
+#define Skeleton_clearLiveBones(...) spSkeleton_clearLiveBones(__VA_ARGS__)
 #define Skeleton_setToSetupPose(...) spSkeleton_setToSetupPose(__VA_ARGS__)
 #define Skeleton_setBonesToSetupPose(...) spSkeleton_setBonesToSetupPose(__VA_ARGS__)
 #define Skeleton_setSlotsToSetupPose(...) spSkeleton_setSlotsToSetupPose(__VA_ARGS__)
@@ -145,6 +175,7 @@ typedef spSkeleton Skeleton;
 #define Skeleton_getAttachmentForSlotIndex(...) spSkeleton_getAttachmentForSlotIndex(__VA_ARGS__)
 #define Skeleton_setAttachment(...) spSkeleton_setAttachment(__VA_ARGS__)
 #define Skeleton_update(...) spSkeleton_update(__VA_ARGS__)
+#define Skeleton_getBounds(...) spSkeleton_getBounds(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
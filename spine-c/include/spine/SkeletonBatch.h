@@ -29,40 +29,42 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *****************************************************************************/
 
-#ifndef SPINE_POLYGONBATCH_H_
-#define SPINE_POLYGONBATCH_H_
+#ifndef SPINE_SKELETONBATCH_H_
+#define SPINE_SKELETONBATCH_H_
 
-#include "cocos2d.h"
+#include <spine/Skeleton.h>
 
-namespace spine {
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-class PolygonBatch : public cocos2d::CCObject {
-public:
-	static PolygonBatch* createWithCapacity (int capacity);
+/* Updates the world transforms of many skeletons of the same skeleton data together. Every skeleton has the same bones and
+ * IK constraints and so takes the same path through the update, so each bone is computed for four skeletons at a time from
+ * instance interleaved storage, in loops the compiler can vectorize. The results are the same as calling
+ * spSkeleton_updateWorldTransform for each skeleton, including for skeletons with live bones: bones live in none of the
+ * skeletons are skipped, so the savings are largest when the skeletons share the same live bones. */
+typedef struct spSkeletonBatch {
+	spSkeletonData* const data;
+	const int skeletonsCount;
+	spSkeleton** const skeletons;
+} spSkeletonBatch;
 
-	/** @js ctor */
-	PolygonBatch();
+/* The skeletons must all have the same skeleton data and must not be disposed before the batch. */
+spSkeletonBatch* spSkeletonBatch_create (spSkeleton** skeletons, int skeletonsCount);
+void spSkeletonBatch_dispose (spSkeletonBatch* self);
 
-	/** @js NA
-	  * @lua NA */
-	virtual ~PolygonBatch();
+/** Same as spSkeleton_updateWorldTransform for each skeleton. Call after the animations are applied to the skeletons. */
+void spSkeletonBatch_updateWorldTransform (spSkeletonBatch* self);
 
-	bool initWithCapacity (int capacity);
-	void add (cocos2d::CCTexture2D* texture,
-		const float* vertices, const float* uvs, int verticesCount,
-		const int* triangles, int trianglesCount,
-		cocos2d::ccColor4B* color);
-	void flush ();
-
-private:
-	int capacity;
-	cocos2d::ccV2F_C4B_T2F* vertices;
-	int verticesCount;
-	GLushort* triangles;
-	int trianglesCount;
-	cocos2d::CCTexture2D* texture;
-};
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonBatch SkeletonBatch;
+#define SkeletonBatch_create(...) spSkeletonBatch_create(__VA_ARGS__)
+#define SkeletonBatch_dispose(...) spSkeletonBatch_dispose(__VA_ARGS__)
+#define SkeletonBatch_updateWorldTransform(...) spSkeletonBatch_updateWorldTransform(__VA_ARGS__)
+#endif
 
+#ifdef __cplusplus
 }
+#endif
 
-#endif // SPINE_POLYGONBATCH_H_
+#endif /* SPINE_SKELETONBATCH_H_ */
@@ -66,11 +66,36 @@ typedef struct spSkeletonData {
 
 	int ikConstraintsCount;
 	spIkConstraintData** ikConstraints;
+
+	/* Computed by spSkeletonData_updateCache and shared by every skeleton of the data. */
+	int* boneParents; /* Index of each bone's parent, or -1 for the root. */
+	/* The steps of spSkeleton_updateWorldTransform: a bone index to update the bone's world transform, or ~i (-1 - i) to
+	 * apply IK constraint i. */
+	int updateOrderCount;
+	int* updateOrder;
+	/* The setup pose copied by spSkeleton_setToSetupPose: the local transform of each bone, laid out like the spBone fields
+	 * from x to flipY, and the setup attachment of each slot resolved for each skin, falling back to the default skin. Row
+	 * skinsCount has the default skin's attachments, for skeletons without a skin. */
+	void* setupBones;
+	spAttachment** setupAttachments; /* skinsCount + 1 rows of slotsCount. */
 } spSkeletonData;
 
 spSkeletonData* spSkeletonData_create ();
 void spSkeletonData_dispose (spSkeletonData* self);
 
+/* Computes the bone parent indices, update order and setup pose. Must be called if bones, IK constraints or skins are added or
+ * removed, or if the setup pose or the skins' attachments change. Called by spSkeletonJson and, if it wasn't yet, by
+ * spSkeleton_create. The cache is freed and rebuilt, so no skeleton of the data may be updated, posed or drawn while this
+ * runs, including on other threads. */
+void spSkeletonData_updateCache (spSkeletonData* self);
+
+/* Removes bones no timeline keys and nothing else uses, moving their children to their parent with the bone's transform folded
+ * into the children's setup pose and translate timelines. Only bones that can be folded exactly are removed: bones without
+ * slots, skinned mesh weights, IK constraints or IK constrained children, with uniform scale and no flips, under a parent whose
+ * world scale is always uniform. Bones the game finds or moves by hand must be named in keptBoneNames. Must be called before
+ * skeletons are created. Returns the number of bones removed. */
+int spSkeletonData_foldStaticBones (spSkeletonData* self, const char** keptBoneNames, int keptBonesCount);
+
 spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName);
 int spSkeletonData_findBoneIndex (const spSkeletonData* self, const char* boneName);
 
@@ -85,10 +110,17 @@ spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const cha
 
 spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self, const char* ikConstraintName);
 
+/** Returns the largest number of floats needed to hold the world vertices of any attachment in any skin. Renderers use this
+ * to decide whether 16-bit indices can address every attachment, see spSkeletonRenderList_create. Walks every skin entry, so
+ * call it once per skeleton data rather than per frame. */
+int spSkeletonData_getMaxWorldVerticesCount (const spSkeletonData* self);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeletonData SkeletonData;
 #define SkeletonData_create(...) spSkeletonData_create(__VA_ARGS__)
 #define SkeletonData_dispose(...) spSkeletonData_dispose(__VA_ARGS__)
+#define SkeletonData_updateCache(...) spSkeletonData_updateCache(__VA_ARGS__)
+#define SkeletonData_foldStaticBones(...) spSkeletonData_foldStaticBones(__VA_ARGS__)
 #define SkeletonData_findBone(...) spSkeletonData_findBone(__VA_ARGS__)
 #define SkeletonData_findBoneIndex(...) spSkeletonData_findBoneIndex(__VA_ARGS__)
 #define SkeletonData_findSlot(...) spSkeletonData_findSlot(__VA_ARGS__)
@@ -96,6 +128,7 @@ typedef spSkeletonData SkeletonData;
 #define SkeletonData_findSkin(...) spSkeletonData_findSkin(__VA_ARGS__)
 #define SkeletonData_findEvent(...) spSkeletonData_findEvent(__VA_ARGS__)
 #define SkeletonData_findAnimation(...) spSkeletonData_findAnimation(__VA_ARGS__)
+#define SkeletonData_getMaxWorldVerticesCount(...) spSkeletonData_getMaxWorldVerticesCount(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
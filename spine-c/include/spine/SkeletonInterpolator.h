@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONINTERPOLATOR_H_
+#define SPINE_SKELETONINTERPOLATOR_H_
+
+#include <spine/Skeleton.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Keeps the two most recent poses of a skeleton, so a skeleton updated at a low fixed rate can be rendered smoothly at a
+ * higher rate. Bone transforms and slot colors are interpolated. Attachments, draw order and FFD vertices are those of the
+ * most recent pose. */
+typedef struct spSkeletonInterpolator {
+	spSkeleton* const skeleton;
+	/* The number of poses captured since creation or reset, up to 2. */
+	const int posesCount;
+} spSkeletonInterpolator;
+
+spSkeletonInterpolator* spSkeletonInterpolator_create (spSkeleton* skeleton);
+void spSkeletonInterpolator_dispose (spSkeletonInterpolator* self);
+
+/** Stores the skeleton's bone transforms and slot colors as the most recent pose. Call after each fixed rate
+ * spSkeleton_updateWorldTransform. */
+void spSkeletonInterpolator_capture (spSkeletonInterpolator* self);
+
+/** Discards the stored poses, eg after the skeleton is moved to a new position, so the next capture is not interpolated from
+ * the old pose. */
+void spSkeletonInterpolator_reset (spSkeletonInterpolator* self);
+
+/** Sets the skeleton's bone transforms, including world transforms, and slot colors between the previous and most recent
+ * poses. Rotation is interpolated the short way around.
+ * @param alpha 0 for the previous pose, 1 for the most recent pose. */
+void spSkeletonInterpolator_apply (spSkeletonInterpolator* self, float alpha);
+
+/** Sets the skeleton's bone transforms and slot colors back to the most recent pose. Call after rendering an interpolated
+ * pose, before the skeleton is updated again. */
+void spSkeletonInterpolator_restore (spSkeletonInterpolator* self);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonInterpolator SkeletonInterpolator;
+#define SkeletonInterpolator_create(...) spSkeletonInterpolator_create(__VA_ARGS__)
+#define SkeletonInterpolator_dispose(...) spSkeletonInterpolator_dispose(__VA_ARGS__)
+#define SkeletonInterpolator_capture(...) spSkeletonInterpolator_capture(__VA_ARGS__)
+#define SkeletonInterpolator_reset(...) spSkeletonInterpolator_reset(__VA_ARGS__)
+#define SkeletonInterpolator_apply(...) spSkeletonInterpolator_apply(__VA_ARGS__)
+#define SkeletonInterpolator_restore(...) spSkeletonInterpolator_restore(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONINTERPOLATOR_H_ */
@@ -46,6 +46,20 @@ typedef struct spSkeletonJson {
 	float scale;
 	spAttachmentLoader* attachmentLoader;
 	const char* const error;
+
+	/* If true, spSkeletonData_foldStaticBones is called with keptBoneNames after the skeleton data is read. */
+	int/*bool*/foldStaticBones;
+	const char** keptBoneNames;
+	int keptBonesCount;
+
+	/* If true, spAnimation_reduceKeys is called for each animation read, with keyTolerance and removeSetupPoseTimelines. */
+	int/*bool*/reduceKeys;
+	float keyTolerance;
+	int/*bool*/removeSetupPoseTimelines;
+
+	/* If true, spAnimation_quantize is called for each animation after the other passes, with these errors. */
+	int/*bool*/quantize;
+	float quantizeTimeError, quantizeRotateError, quantizeTranslateError, quantizeScaleError, quantizeColorError;
 } spSkeletonJson;
 
 spSkeletonJson* spSkeletonJson_createWithLoader (spAttachmentLoader* attachmentLoader);
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONPOSE_H_
+#define SPINE_SKELETONPOSE_H_
+
+#include <spine/Skeleton.h>
+#include <spine/AnimationState.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A skeleton's animated state: the skeleton color, time, flip and position, bone local transforms, slot colors, attachments
+ * and attachment times, draw order and IK constraint mix and bend direction. It is stored in one contiguous buffer that has
+ * no pointers into the skeleton, so buffers can be copied with memcpy, eg into a ring buffer for rollback, and restored to any
+ * skeleton for the same skeleton data. The skin, FFD vertices and world transforms are not stored. */
+typedef struct spSkeletonPose {
+	spSkeletonData* const data;
+	const int size;
+	void* const buffer;
+} spSkeletonPose;
+
+spSkeletonPose* spSkeletonPose_create (spSkeletonData* data);
+void spSkeletonPose_dispose (spSkeletonPose* self);
+
+void spSkeleton_capturePose (const spSkeleton* self, spSkeletonPose* pose);
+/** Returns false, without changing the skeleton, if the pose was captured from a skeleton with different bones, slots or IK
+ * constraints, or by a different version of the runtime. spSkeleton_updateWorldTransform must be called afterward. */
+int/*bool*/spSkeleton_restorePose (spSkeleton* self, const spSkeletonPose* pose);
+
+/**/
+
+/* The times of each track's current entry, and of the entry it is mixing from. */
+typedef struct spAnimationStatePose {
+	const int size;
+	void* const buffer;
+} spAnimationStatePose;
+
+/* @param tracksCount The buffer grows when capturing more tracks. */
+spAnimationStatePose* spAnimationStatePose_create (int tracksCount);
+void spAnimationStatePose_dispose (spAnimationStatePose* self);
+
+void spAnimationState_capturePose (const spAnimationState* self, spAnimationStatePose* pose);
+/** Restores the times of the tracks whose entries are the same as when the pose was captured. Returns false if any track has
+ * a different entry, animation or entry being mixed from, in which case that track is left as is. */
+int/*bool*/spAnimationState_restorePose (spAnimationState* self, const spAnimationStatePose* pose);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonPose SkeletonPose;
+#define SkeletonPose_create(...) spSkeletonPose_create(__VA_ARGS__)
+#define SkeletonPose_dispose(...) spSkeletonPose_dispose(__VA_ARGS__)
+#define Skeleton_capturePose(...) spSkeleton_capturePose(__VA_ARGS__)
+#define Skeleton_restorePose(...) spSkeleton_restorePose(__VA_ARGS__)
+typedef spAnimationStatePose AnimationStatePose;
+#define AnimationStatePose_create(...) spAnimationStatePose_create(__VA_ARGS__)
+#define AnimationStatePose_dispose(...) spAnimationStatePose_dispose(__VA_ARGS__)
+#define AnimationState_capturePose(...) spAnimationState_capturePose(__VA_ARGS__)
+#define AnimationState_restorePose(...) spAnimationState_restorePose(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONPOSE_H_ */
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONRASTERIZER_H_
+#define SPINE_SKELETONRASTERIZER_H_
+
+#include <spine/SkeletonRenderList.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A decoded atlas page image. To draw with spSkeletonRasterizer, _spAtlasPage_createTexture must set the page's
+ * rendererObject to one of these. */
+typedef struct spRasterTexture {
+	int width, height;
+	const unsigned char* pixels; /* RGBA, 4 bytes per pixel, rows from top to bottom. */
+} spRasterTexture;
+
+/* Draws skeletons into an RGBA image on the CPU, without a graphics context. */
+typedef struct spSkeletonRasterizer {
+	const int width, height;
+	unsigned char* const pixels; /* RGBA with premultiplied alpha, 4 bytes per pixel, rows from top to bottom. */
+
+	/* Maps world coordinates to pixels: pixelX = worldX * scaleX + x. Defaults to 1, 1, 0, 0. */
+	float scaleX, scaleY, x, y;
+	/* When true, texture pixels are already premultiplied by alpha. */
+	int/*bool*/premultipliedAlpha;
+} spSkeletonRasterizer;
+
+spSkeletonRasterizer* spSkeletonRasterizer_create (int width, int height);
+void spSkeletonRasterizer_dispose (spSkeletonRasterizer* self);
+
+/* Fills the image with a color, components from 0 to 1. */
+void spSkeletonRasterizer_clear (spSkeletonRasterizer* self, float r, float g, float b, float a);
+
+/* Draws the skeleton's attachments in draw order, with bilinear texture filtering and the slot blend modes. */
+void spSkeletonRasterizer_drawSkeleton (spSkeletonRasterizer* self, spSkeleton* skeleton);
+
+/* Draws a render list that was built for a skeleton whose atlas page rendererObjects are spRasterTextures. */
+void spSkeletonRasterizer_drawRenderList (spSkeletonRasterizer* self, const spSkeletonRenderList* renderList);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spRasterTexture RasterTexture;
+typedef spSkeletonRasterizer SkeletonRasterizer;
+#define SkeletonRasterizer_create(...) spSkeletonRasterizer_create(__VA_ARGS__)
+#define SkeletonRasterizer_dispose(...) spSkeletonRasterizer_dispose(__VA_ARGS__)
+#define SkeletonRasterizer_clear(...) spSkeletonRasterizer_clear(__VA_ARGS__)
+#define SkeletonRasterizer_drawSkeleton(...) spSkeletonRasterizer_drawSkeleton(__VA_ARGS__)
+#define SkeletonRasterizer_drawRenderList(...) spSkeletonRasterizer_drawRenderList(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONRASTERIZER_H_ */
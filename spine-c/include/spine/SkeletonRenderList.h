@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONRENDERLIST_H_
+#define SPINE_SKELETONRENDERLIST_H_
+
+#include <spine/Skeleton.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Same memory layout as SFML's sf::Vertex and cocos2d-x's V2F_C4B_T2F, so backends can upload it directly. */
+typedef struct spRenderVertex {
+	float x, y;
+	unsigned char r, g, b, a;
+	float u, v;
+} spRenderVertex;
+
+/* Attachments drawn consecutively with the same texture and blend mode. Indices are relative to verticesStart. */
+typedef struct spRenderBatch {
+	void* rendererObject; /* The atlas page rendererObject, usually the texture. */
+	spBlendMode blendMode;
+	int verticesStart, verticesCount;
+	int indicesStart, indicesCount;
+} spRenderBatch;
+
+typedef struct spSkeletonRenderList {
+	/* When true, colors are multiplied by alpha. */
+	int/*bool*/premultipliedAlpha;
+	/* When true, indices are unsigned int, otherwise unsigned short and a batch is split before it exceeds 65536 vertices. A
+	 * single attachment with more vertices can't be split, so 32-bit indices are needed when
+	 * spSkeletonData_getMaxWorldVerticesCount is over 131072. */
+	const int/*bool*/use32BitIndices;
+	/* When true, attachments whose bounds (see spSlot_getBounds) are outside the cull rectangle, in world coordinates, are
+	 * skipped without computing their vertices. */
+	int/*bool*/cull;
+	float cullMinX, cullMinY, cullMaxX, cullMaxY;
+
+	int verticesCount;
+	spRenderVertex* const vertices;
+	int indicesCount;
+	void* const indices;
+	int batchesCount;
+	spRenderBatch* const batches;
+} spSkeletonRenderList;
+
+spSkeletonRenderList* spSkeletonRenderList_create (int/*bool*/use32BitIndices);
+void spSkeletonRenderList_dispose (spSkeletonRenderList* self);
+
+/** Computes the vertices, indices and batches for the skeleton's attachments in draw order. The buffers are reused and only
+ * grow, so after the first few frames this does not allocate. World vertices come from spSlot_getWorldVertices, so only the
+ * skeleton's slot caches are written and different skeletons can be updated on different threads at the same time, even
+ * when they share skeleton data. */
+void spSkeletonRenderList_update (spSkeletonRenderList* self, spSkeleton* skeleton);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spRenderVertex RenderVertex;
+typedef spRenderBatch RenderBatch;
+typedef spSkeletonRenderList SkeletonRenderList;
+#define SkeletonRenderList_create(...) spSkeletonRenderList_create(__VA_ARGS__)
+#define SkeletonRenderList_dispose(...) spSkeletonRenderList_dispose(__VA_ARGS__)
+#define SkeletonRenderList_update(...) spSkeletonRenderList_update(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONRENDERLIST_H_ */
@@ -64,6 +64,9 @@ const char* spSkin_getAttachmentName (const spSkin* self, int slotIndex, int att
 /** Attach each attachment in this skin if the corresponding attachment in oldSkin is currently attached. */
 void spSkin_attachAll (const spSkin* self, struct spSkeleton* skeleton, const spSkin* oldspSkin);
 
+/** Returns the largest number of floats needed to hold the world vertices of any attachment in this skin. */
+int spSkin_getMaxWorldVerticesCount (const spSkin* self);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSkin Skin;
 #define Skin_create(...) spSkin_create(__VA_ARGS__)
@@ -72,6 +75,7 @@ typedef spSkin Skin;
 #define Skin_getAttachment(...) spSkin_getAttachment(__VA_ARGS__)
 #define Skin_getAttachmentName(...) spSkin_getAttachmentName(__VA_ARGS__)
 #define Skin_attachAll(...) spSkin_attachAll(__VA_ARGS__)
+#define Skin_getMaxWorldVerticesCount(...) spSkin_getMaxWorldVerticesCount(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
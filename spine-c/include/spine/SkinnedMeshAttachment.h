@@ -59,6 +59,12 @@ typedef struct spSkinnedMeshAttachment {
 
 	float r, g, b, a;
 
+	/* Each bone that influences the mesh and the largest distance of a weighted vertex from it, in the bone's space. Set
+	 * by updateBounds. */
+	int boundsBonesCount;
+	int* boundsBones;
+	float* boundsRadii;
+
 	void* rendererObject;
 	int regionOffsetX, regionOffsetY; /* Pixels stripped from the bottom left, unrotated. */
 	int regionWidth, regionHeight; /* Unrotated, stripped pixel size. */
@@ -74,12 +80,15 @@ typedef struct spSkinnedMeshAttachment {
 
 spSkinnedMeshAttachment* spSkinnedMeshAttachment_create (const char* name);
 void spSkinnedMeshAttachment_updateUVs (spSkinnedMeshAttachment* self);
+/* Computes the bounds bones and radii. Call after changing the bones or weights. */
+void spSkinnedMeshAttachment_updateBounds (spSkinnedMeshAttachment* self);
 void spSkinnedMeshAttachment_computeWorldVertices (spSkinnedMeshAttachment* self, spSlot* slot, float* worldVertices);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spSkinnedMeshAttachment SkinnedMeshAttachment;
 #define SkinnedMeshAttachment_create(...) spSkinnedMeshAttachment_create(__VA_ARGS__)
 #define SkinnedMeshAttachment_updateUVs(...) spSkinnedMeshAttachment_updateUVs(__VA_ARGS__)
+#define SkinnedMeshAttachment_updateBounds(...) spSkinnedMeshAttachment_updateBounds(__VA_ARGS__)
 #define SkinnedMeshAttachment_computeWorldVertices(...) spSkinnedMeshAttachment_computeWorldVertices(__VA_ARGS__)
 #endif
 
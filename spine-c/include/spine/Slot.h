@@ -49,6 +49,8 @@ typedef struct spSlot {
 	int attachmentVerticesCapacity;
 	int attachmentVerticesCount;
 	float* attachmentVertices;
+	/* Incremented when attachmentVertices are changed, so cached world vertices are recomputed. */
+	int attachmentVerticesVersion;
 
 #ifdef __cplusplus
 	spSlot() :
@@ -58,7 +60,8 @@ typedef struct spSlot {
 		attachment(0),
 		attachmentVerticesCapacity(0),
 		attachmentVerticesCount(0),
-		attachmentVertices(0) {
+		attachmentVertices(0),
+		attachmentVerticesVersion(0) {
 	}
 #endif
 } spSlot;
@@ -74,6 +77,23 @@ float spSlot_getAttachmentTime (const spSlot* self);
 
 void spSlot_setToSetupPose (spSlot* self);
 
+/* Computes a conservative axis aligned bounding box of the attachment in world coordinates from the bone positions and the
+ * attachment radius, without computing its vertices. Returns false if the attachment is not a region or mesh.
+ * @param bounds minX, minY, maxX, maxY. */
+int/*bool*/spSlot_getBounds (const spSlot* self, float* bounds);
+
+/* Returns the world vertices of the region, mesh, skinned mesh or bounding box attachment, or 0 for other attachments. The
+ * vertices are cached and only recomputed when the attachment, the world transform of the bones it depends on, the skeleton
+ * position or the attachment vertices version change, so rendering, bounds and hit testing in the same frame share them.
+ * @param verticesCount Set to the number of floats returned. */
+const float* spSlot_getWorldVertices (spSlot* self, int* verticesCount);
+
+/* Returns the product of the skeleton, slot and attachment colors as 4 bytes in RGBA memory order, so it can be stored in a
+ * vertex with one 32 bit write. Attachments without a color count as white. The color is cached and only recomputed when
+ * one of the colors or premultipliedAlpha changes.
+ * @param premultipliedAlpha When true, RGB are multiplied by alpha. */
+unsigned int spSlot_getPackedColor (spSlot* self, int/*bool*/premultipliedAlpha);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSlot Slot;
 #define Slot_create(...) spSlot_create(__VA_ARGS__)
@@ -82,6 +102,9 @@ typedef spSlot Slot;
 #define Slot_setAttachmentTime(...) spSlot_setAttachmentTime(__VA_ARGS__)
 #define Slot_getAttachmentTime(...) spSlot_getAttachmentTime(__VA_ARGS__)
 #define Slot_setToSetupPose(...) spSlot_setToSetupPose(__VA_ARGS__)
+#define Slot_getBounds(...) spSlot_getBounds(__VA_ARGS__)
+#define Slot_getWorldVertices(...) spSlot_getWorldVertices(__VA_ARGS__)
+#define Slot_getPackedColor(...) spSlot_getPackedColor(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -26,6 +26,9 @@
  - OOP in C tends to lose type safety. Macros for casting are provided in extension.h to give context for why a cast is being done.
 
  - If SPINE_SHORT_NAMES is defined, the "sp" prefix for all class names is optional.
+
+ - If SPINE_FAST_TRIG is defined, bone world transforms use a polynomial sine and cosine with an absolute error under 1e-6
+ instead of the C library's.
  */
 
 #ifndef SPINE_EXTENSION_H_
@@ -68,6 +71,7 @@
 #define COS(A) cosf(A)
 #define SQRT(A) sqrtf(A)
 #define ACOS(A) acosf(A)
+#define FABS(A) fabsf(A)
 #else
 #define FMOD(A,B) (float)fmod(A, B)
 #define ATAN2(A,B) (float)atan2(A, B)
@@ -75,6 +79,7 @@
 #define SIN(A) (float)sin(A)
 #define SQRT(A) (float)sqrt(A)
 #define ACOS(A) (float)acos(A)
+#define FABS(A) (float)fabs(A)
 #endif
 
 #include <stdlib.h>
@@ -119,14 +124,46 @@ void _free (void* ptr);
 void _setMalloc (void* (*_malloc) (size_t size));
 void _setDebugMalloc (void* (*_malloc) (size_t size, const char* file, int line));
 void _setFree (void (*_free) (void* ptr));
+/* For debugging, the listener is called before every allocation with the file and line that made it. Setting it after
+ * warming up and clearing it after a frame's update, apply and draw reports allocations made in the steady state. */
+void _setAllocationListener (void (*listener) (size_t size, const char* file, int line));
 
 char* _readFile (const char* path, int* length);
 
+/* Sets the sine and cosine of the angle in radians, see SPINE_FAST_TRIG. */
+void _spSinCos (float radians, float* sine, float* cosine);
+/* Returns the angle in degrees wrapped to [-180, 180], the same as adding or subtracting 360 until it is in range. */
+float _spWrapDegrees (float degrees);
+
 /**/
 
+/* A listener call queued by spAnimationState_apply when deferEvents is true. */
+typedef struct _spEventQueueEntry {
+	spTrackEntry* entry; /* 0 once the track has changed and the remaining calls for it are dropped. */
+	int trackIndex;
+	spEventType type;
+	spEvent* event;
+	int loopCount;
+} _spEventQueueEntry;
+
 typedef struct _spAnimationState {
 	spAnimationState super;
 	spEvent** events;
+	int eventsCapacity;
+
+	_spEventQueueEntry* queue;
+	int queueCount, queueCapacity;
+
+	int tracksCapacity;
+	spTrackEntry* trackEntryPool; /* Disposed entries for reuse, linked by next. */
+	unsigned int lastTrackEntrySerial;
+
+	/* For each track, the properties replaced by the tracks above it, see _spAnimationState_updateSkipMasks. */
+	unsigned int* skipMasks;
+	int skipMasksCapacity;
+
+	/* When set, apply advances the tracks and fires their events without posing the skeleton, see spPoseGroup_apply. */
+	int eventsOnly;
 
 	spTrackEntry* (*createTrackEntry) (spAnimationState* self);
 	void (*disposeTrackEntry) (spTrackEntry* entry);
@@ -135,17 +172,127 @@ typedef struct _spAnimationState {
 	_spAnimationState() :
 		super(),
 		events(0),
+		eventsCapacity(0),
+		queue(0),
+		queueCount(0), queueCapacity(0),
+		tracksCapacity(0),
+		trackEntryPool(0),
+		lastTrackEntrySerial(0),
+		skipMasks(0),
+		skipMasksCapacity(0),
+		eventsOnly(0),
 		createTrackEntry(0),
 		disposeTrackEntry(0) {
 	}
 #endif
 } _spAnimationState;
 
+typedef struct _spTrackEntry {
+	spTrackEntry super;
+
+	/* Unique within the state each time the entry is taken from the pool, so a recycled entry can be told apart. */
+	unsigned int serial;
+
+	/* The timeline pairs of previous and animation, see _spAnimation_pairTimelines. Only depends on the two animations, so it
+	 * is kept when the entry is pooled. */
+	const spAnimation* pairsFrom;
+	const spAnimation* pairsTo;
+	int/*bool*/paired;
+	int pairsCapacity;
+	int* pairs;
+
+#ifdef __cplusplus
+	_spTrackEntry() :
+		super(),
+		serial(0),
+		pairsFrom(0),
+		pairsTo(0),
+		paired(0),
+		pairsCapacity(0),
+		pairs(0) {
+	}
+#endif
+} _spTrackEntry;
+
+/* Entries are taken from and returned to the state's pool. */
 spTrackEntry* _spTrackEntry_create (spAnimationState* self);
 void _spTrackEntry_dispose (spTrackEntry* self);
 
 /**/
 
+/* Returns the index of the timeline's property in spAnimation replaceMask, or -1. */
+int _spTimeline_getMaskIndex (const spTimeline* self, const spSkeletonData* skeletonData);
+/* Decodes the keys of a quantized timeline back into its frames. Does nothing if the timeline isn't quantized. */
+void _spTimeline_dequantize (spTimeline* self);
+int _spAnimation_getMaskWordsCount (const spSkeletonData* skeletonData);
+/* Same as spAnimation_mix, but skips the timelines for properties set in skipMask and, for bone timelines, for bones not set
+ * in bonesMask. Either mask may be 0. */
+void _spAnimation_mixMasked (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount, float alpha, const unsigned int* skipMask, const unsigned int* bonesMask);
+/* Pairs the rotate, translate, scale, color and IK timelines of the animations that key the same property. pairs must hold
+ * to->timelinesCount + from->timelinesCount ints: for each timeline of to, the index of the timeline of from for the same
+ * property or -1, then for each timeline of from, whether it is paired. Returns false if spAnimation_updateMasks wasn't
+ * called for both animations. */
+int _spAnimation_pairTimelines (const spAnimation* from, const spAnimation* to, const spSkeletonData* skeletonData, int* pairs);
+/* Same as applying from with full alpha and then mixing self with alpha, but each property keyed by both is evaluated for
+ * both animations and written once. pairs is from _spAnimation_pairTimelines. Returns false without applying anything if pairs
+ * is 0. */
+int _spAnimation_crossfade (const spAnimation* from, float fromTime, int fromLoop, const spAnimation* self, spSkeleton* skeleton,
+		float lastTime, float time, int loop, spEvent** events, int* eventsCount, float alpha, const unsigned int* skipMask,
+		const unsigned int* bonesMask, const int* pairs);
+/* Same as spAnimation_mix, but only the event timelines are applied. */
+void _spAnimation_fireEvents (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount);
+
+/**/
+
+/* Sets the bits in liveBones for the bones the attachment needs on the slot or, for the skin, for each of its attachments. See
+ * spSkeleton_updateLiveBones. */
+void _spSkeleton_addLiveBones (const spSkeleton* self, int slotIndex, const spAttachment* attachment, int/*bool*/drawn,
+		unsigned int* liveBones);
+void _spSkin_addLiveBones (const spSkin* self, const spSkeleton* skeleton, int/*bool*/drawn, unsigned int* liveBones);
+/* The row of spSkeletonData setupAttachments for the skeleton's skin, or 0 if the skin isn't one of the data's skins. */
+spAttachment** _spSkeleton_getSetupAttachments (const spSkeleton* self);
+/* For each IK constraint, whether it is applied, or 0 if the skeleton has no live bones and all are applied. */
+const int* _spSkeleton_getLiveIkConstraints (const spSkeleton* self);
+
+/**/
+
+/* A skeleton's bones and slots are each allocated in one block, so walking them in order touches contiguous memory. The
+ * create functions set the pointers to the uninitialized elements, which are then initialized in order. The dispose functions
+ * take the same pointers, with the block's first element first. */
+void _spBone_createBones (spBone** bones, int count);
+void _spBone_init (spBone* self, spBoneData* data, spSkeleton* skeleton, spBone* parent);
+void _spBone_disposeBones (spBone** bones, int count);
+void _spSlot_createSlots (spSlot** slots, int count);
+void _spSlot_init (spSlot* self, spSlotData* data, spBone* bone, int index);
+void _spSlot_disposeSlots (spSlot** slots, int count);
+
+/* Grows the slot's world vertices cache to fit the attachment, see spSlot_getWorldVertices. */
+void _spSlot_reserveWorldVertices (spSlot* self, const spAttachment* attachment);
+
+/* The local transform of a bone, laid out like the spBone fields from x to flipY, so it can be copied over them. Held in
+ * spSkeletonData setupBones for the setup pose, and in spSkeletonPose. */
+typedef struct {
+	float x, y;
+	float rotation, rotationIK;
+	float scaleX, scaleY;
+	int flipX, flipY;
+} _spBoneSetupPose;
+
+/* Copies the local transforms of all the bones of a block from _spBone_createBones to or from poses, walking the block with a
+ * fixed stride. The transforms can't be copied as one range, since each bone's data, skeleton and parent pointers sit between
+ * them and differ between skeletons. */
+void _spBone_getLocalPoses (spBone* const* bones, int count, _spBoneSetupPose* poses);
+void _spBone_setLocalPoses (spBone* const* bones, int count, const _spBoneSetupPose* poses);
+
+/* The range of the slot's attachmentVertices that may differ from the attachment's setup vertices. FFD timelines only write
+ * the vertices they key and those in this range. */
+void _spSlot_getDeformedRange (const spSlot* self, int* start, int* end);
+void _spSlot_setDeformedRange (spSlot* self, int start, int end);
+
+/**/
+
 void _spAttachmentLoader_init (spAttachmentLoader* self, /**/
 void (*dispose) (spAttachmentLoader* self), /**/
 		spAttachment* (*newAttachment) (spAttachmentLoader* self, spSkin* skin, spAttachmentType type, const char* name,
@@ -46,9 +46,15 @@
 #include <spine/SkinnedMeshAttachment.h>
 #include <spine/BoundingBoxAttachment.h>
 #include <spine/Skeleton.h>
+#include <spine/SkeletonBatch.h>
 #include <spine/SkeletonBounds.h>
+#include <spine/SkeletonRasterizer.h>
+#include <spine/SkeletonRenderList.h>
 #include <spine/SkeletonData.h>
+#include <spine/SkeletonInterpolator.h>
 #include <spine/SkeletonJson.h>
+#include <spine/SkeletonPose.h>
+#include <spine/PoseGroup.h>
 #include <spine/Skin.h>
 #include <spine/Slot.h>
 #include <spine/SlotData.h>
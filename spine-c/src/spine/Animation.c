@@ -47,10 +47,72 @@ void spAnimation_dispose (spAnimation* self) {
 	for (i = 0; i < self->timelinesCount; ++i)
 		spTimeline_dispose(self->timelines[i]);
 	FREE(self->timelines);
+	FREE(self->replaceMask);
+	FREE(self->maskedTimelines);
 	FREE(self->name);
 	FREE(self);
 }
 
+int _spTimeline_getMaskIndex (const spTimeline* self, const spSkeletonData* skeletonData) {
+	switch (self->type) {
+	case SP_TIMELINE_ROTATE:
+		return SUB_CAST(spBaseTimeline, self)->boneIndex * 3;
+	case SP_TIMELINE_TRANSLATE:
+		return SUB_CAST(spBaseTimeline, self)->boneIndex * 3 + 1;
+	case SP_TIMELINE_SCALE:
+		return SUB_CAST(spBaseTimeline, self)->boneIndex * 3 + 2;
+	case SP_TIMELINE_COLOR:
+		return skeletonData->bonesCount * 3 + SUB_CAST(spColorTimeline, self)->slotIndex;
+	case SP_TIMELINE_IKCONSTRAINT:
+		return skeletonData->bonesCount * 3 + skeletonData->slotsCount + SUB_CAST(spIkConstraintTimeline, self)->ikConstraintIndex;
+	default:
+		return -1;
+	}
+}
+
+int _spAnimation_getMaskWordsCount (const spSkeletonData* skeletonData) {
+	return (skeletonData->bonesCount * 3 + skeletonData->slotsCount + skeletonData->ikConstraintsCount + 31) >> 5;
+}
+
+static float _spCurveTimeline_getFirstTime (const spCurveTimeline* self, const float* frames);
+
+void spAnimation_updateMasks (spAnimation* self, const spSkeletonData* skeletonData) {
+	int i, ii;
+	FREE(self->replaceMask);
+	CONST_CAST(unsigned int*, self->replaceMask) = CALLOC(unsigned int, _spAnimation_getMaskWordsCount(skeletonData));
+	FREE(self->maskedTimelines);
+	CONST_CAST(int*, self->maskedTimelines) = MALLOC(int, self->timelinesCount);
+	self->maskedTimelinesCount = 0;
+	for (i = 0; i < self->timelinesCount; ++i) {
+		const spTimeline* timeline = self->timelines[i];
+		int index = _spTimeline_getMaskIndex(timeline, skeletonData);
+		const float* frames;
+		if (index == -1) continue;
+
+		/* Timelines are usually grouped by bone and slot, so this insertion sort rarely moves more than a few entries. */
+		for (ii = self->maskedTimelinesCount; ii > 0; --ii) {
+			if (_spTimeline_getMaskIndex(self->timelines[self->maskedTimelines[ii - 1]], skeletonData) <= index) break;
+			self->maskedTimelines[ii] = self->maskedTimelines[ii - 1];
+		}
+		self->maskedTimelines[ii] = i;
+		self->maskedTimelinesCount++;
+
+		/* Timelines don't change the pose before their first frame. */
+		switch (timeline->type) {
+		case SP_TIMELINE_COLOR:
+			frames = SUB_CAST(spColorTimeline, timeline)->frames;
+			break;
+		case SP_TIMELINE_IKCONSTRAINT:
+			frames = SUB_CAST(spIkConstraintTimeline, timeline)->frames;
+			break;
+		default:
+			frames = SUB_CAST(spBaseTimeline, timeline)->frames;
+		}
+		if (_spCurveTimeline_getFirstTime(SUB_CAST(spCurveTimeline, timeline), frames) <= 0)
+			self->replaceMask[index >> 5] |= 1u << (index & 31);
+	}
+}
+
 void spAnimation_apply (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events,
 		int* eventsCount) {
 	int i, n = self->timelinesCount;
@@ -77,6 +139,60 @@ void spAnimation_mix (const spAnimation* self, spSkeleton* skeleton, float lastT
 		spTimeline_apply(self->timelines[i], skeleton, lastTime, time, events, eventsCount, alpha);
 }
 
+/* Returns true if the timeline's property is set in skipMask or, for bone timelines, its bone is not set in bonesMask. */
+static int _spTimeline_isMasked (const spTimeline* self, const spSkeletonData* skeletonData, const unsigned int* skipMask,
+		const unsigned int* bonesMask) {
+	int index;
+	if (self->type == SP_TIMELINE_FLIPX || self->type == SP_TIMELINE_FLIPY) {
+		index = SUB_CAST(spFlipTimeline, self)->boneIndex;
+		return bonesMask && !(bonesMask[index >> 5] & (1u << (index & 31)));
+	}
+	index = _spTimeline_getMaskIndex(self, skeletonData);
+	if (index == -1) return 0;
+	if (skipMask && (skipMask[index >> 5] & (1u << (index & 31)))) return 1;
+	if (bonesMask && index < skeletonData->bonesCount * 3) {
+		index /= 3;
+		return !(bonesMask[index >> 5] & (1u << (index & 31)));
+	}
+	return 0;
+}
+
+void _spAnimation_mixMasked (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount, float alpha, const unsigned int* skipMask, const unsigned int* bonesMask) {
+	int i, n = self->timelinesCount;
+
+	if (!skipMask && !bonesMask) {
+		spAnimation_mix(self, skeleton, lastTime, time, loop, events, eventsCount, alpha);
+		return;
+	}
+
+	if (loop && self->duration) {
+		time = FMOD(time, self->duration);
+		lastTime = FMOD(lastTime, self->duration);
+	}
+
+	for (i = 0; i < n; ++i) {
+		const spTimeline* timeline = self->timelines[i];
+		if (_spTimeline_isMasked(timeline, skeleton->data, skipMask, bonesMask)) continue;
+		spTimeline_apply(timeline, skeleton, lastTime, time, events, eventsCount, alpha);
+	}
+}
+
+void _spAnimation_fireEvents (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount) {
+	int i, n = self->timelinesCount;
+
+	if (loop && self->duration) {
+		time = FMOD(time, self->duration);
+		lastTime = FMOD(lastTime, self->duration);
+	}
+
+	for (i = 0; i < n; ++i) {
+		const spTimeline* timeline = self->timelines[i];
+		if (timeline->type == SP_TIMELINE_EVENT) spTimeline_apply(timeline, skeleton, lastTime, time, events, eventsCount, 1);
+	}
+}
+
 /**/
 
 typedef struct _spTimelineVtable {
@@ -103,6 +219,27 @@ void spTimeline_dispose (spTimeline* self) {
 	VTABLE(spTimeline, self)->dispose(self);
 }
 
+/* Returns true if the bone is not in the skeleton's live bones, so timelines can skip it. See spSkeleton_updateLiveBones. */
+static int _isBonePruned (const spSkeleton* skeleton, int boneIndex) {
+	return skeleton->liveBones && !(skeleton->liveBones[boneIndex >> 5] & (1u << (boneIndex & 31)));
+}
+
+/* Returns true if the timeline keys a bone that is not in the skeleton's live bones. */
+static int _spTimeline_isPruned (const spTimeline* self, const spSkeleton* skeleton) {
+	if (!skeleton->liveBones) return 0;
+	switch (self->type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE:
+		return _isBonePruned(skeleton, SUB_CAST(spBaseTimeline, self)->boneIndex);
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY:
+		return _isBonePruned(skeleton, SUB_CAST(spFlipTimeline, self)->boneIndex);
+	default:
+		return 0;
+	}
+}
+
 void spTimeline_apply (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 		int* eventsCount, float alpha) {
 	VTABLE(spTimeline, self)->apply(self, skeleton, lastTime, time, firedEvents, eventsCount, alpha);
@@ -121,9 +258,76 @@ void (*dispose) (spTimeline* self), /**/
 	self->curves = CALLOC(float, (framesCount - 1) * BEZIER_SIZE);
 }
 
+typedef struct {
+	/* Times are 16 bit ticks from timeOffset, values are 16 bit or, if bytes is set, 8 bit steps from their offset. */
+	float timeOffset, timeScale;
+	float offsets[4], scales[4];
+	int valuesCount;
+	unsigned short* times;
+	unsigned short* values;
+	unsigned char* bytes;
+} _spQuantizedKeys;
+
+static void _spQuantizedKeys_dispose (const _spQuantizedKeys* self) {
+	FREE(self->times);
+	FREE(self->values);
+	FREE(self->bytes);
+	FREE(self);
+}
+
+static float _spQuantizedKeys_getTime (const _spQuantizedKeys* self, int keyIndex) {
+	return self->timeOffset + self->times[keyIndex] * self->timeScale;
+}
+
+/* Writes the time and values of a key like they are in frames. */
+static void _spQuantizedKeys_decode (const _spQuantizedKeys* self, int keyIndex, float* key) {
+	int i, n = self->valuesCount;
+	key[0] = _spQuantizedKeys_getTime(self, keyIndex);
+	if (self->bytes) {
+		for (i = 0; i < n; ++i)
+			key[i + 1] = self->offsets[i] + self->bytes[keyIndex * n + i] * self->scales[i];
+	} else {
+		for (i = 0; i < n; ++i)
+			key[i + 1] = self->offsets[i] + self->values[keyIndex * n + i] * self->scales[i];
+	}
+}
+
 void _spCurveTimeline_deinit (spCurveTimeline* self) {
 	_spTimeline_deinit(SUPER(self));
 	FREE(self->curves);
+	if (self->quantized) _spQuantizedKeys_dispose((const _spQuantizedKeys*)self->quantized);
+}
+
+/* Decodes the keys of a quantized timeline back into frames, so they can be read and changed. */
+static void _spCurveTimeline_dequantize (spCurveTimeline* self, float** frames, int framesCount) {
+	const _spQuantizedKeys* keys = (const _spQuantizedKeys*)self->quantized;
+	int i, entrySize;
+	if (!keys) return;
+	entrySize = keys->valuesCount + 1;
+	*frames = MALLOC(float, framesCount);
+	for (i = 0; i < framesCount; i += entrySize)
+		_spQuantizedKeys_decode(keys, i / entrySize, *frames + i);
+	_spQuantizedKeys_dispose(keys);
+	CONST_CAST(const void*, self->quantized) = 0;
+}
+
+void _spTimeline_dequantize (spTimeline* self) {
+	switch (self->type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE: {
+		spBaseTimeline* baseTimeline = SUB_CAST(spBaseTimeline, self);
+		_spCurveTimeline_dequantize(SUPER(baseTimeline), &CONST_CAST(float*, baseTimeline->frames), baseTimeline->framesCount);
+		break;
+	}
+	case SP_TIMELINE_COLOR: {
+		spColorTimeline* colorTimeline = SUB_CAST(spColorTimeline, self);
+		_spCurveTimeline_dequantize(SUPER(colorTimeline), &CONST_CAST(float*, colorTimeline->frames), colorTimeline->framesCount);
+		break;
+	}
+	default:
+		break;
+	}
 }
 
 void spCurveTimeline_setLinear (spCurveTimeline* self, int frameIndex) {
@@ -218,6 +422,54 @@ static int binarySearch1 (float *values, int valuesLength, float target) {
 	return 0;
 }
 
+static float _spCurveTimeline_getFirstTime (const spCurveTimeline* self, const float* frames) {
+	return self->quantized ? _spQuantizedKeys_getTime((const _spQuantizedKeys*)self->quantized, 0) : frames[0];
+}
+
+/* Finds the keys to interpolate at time. Returns 0 if time is before the first key, else the frames holding the keys: the
+ * timeline's frames or, if it is quantized, the keys decoded into buffer. Sets frameIndex to the key to interpolate to and
+ * curveIndex to the key before it or, if time is after the last key, frameIndex to the last key and curveIndex to -1. */
+static const float* _spCurveTimeline_findKey (const spCurveTimeline* self, float* frames, int framesCount, int entrySize,
+		float time, float* buffer, int* frameIndex, int* curveIndex) {
+	const _spQuantizedKeys* keys = (const _spQuantizedKeys*)self->quantized;
+	int low, high, current, lastKey = framesCount / entrySize - 1;
+
+	if (!keys) {
+		if (time < frames[0]) return 0; /* Time is before first frame. */
+		if (time >= frames[framesCount - entrySize]) { /* Time is after last frame. */
+			*frameIndex = framesCount - entrySize;
+			*curveIndex = -1;
+			return frames;
+		}
+		*frameIndex = binarySearch(frames, framesCount, time, entrySize);
+		*curveIndex = *frameIndex / entrySize - 1;
+		return frames;
+	}
+
+	if (time < _spQuantizedKeys_getTime(keys, 0)) return 0;
+	if (time >= _spQuantizedKeys_getTime(keys, lastKey)) {
+		_spQuantizedKeys_decode(keys, lastKey, buffer);
+		*frameIndex = 0;
+		*curveIndex = -1;
+		return buffer;
+	}
+	/* The first key after time. */
+	low = 1;
+	high = lastKey;
+	while (low < high) {
+		current = (low + high) >> 1;
+		if (_spQuantizedKeys_getTime(keys, current) <= time)
+			low = current + 1;
+		else
+			high = current;
+	}
+	_spQuantizedKeys_decode(keys, low - 1, buffer);
+	_spQuantizedKeys_decode(keys, low, buffer + entrySize);
+	*frameIndex = entrySize;
+	*curveIndex = low - 1;
+	return buffer;
+}
+
 /*static int linearSearch (float *values, int valuesLength, float target, int step) {
  int i, last = valuesLength - step;
  for (i = 0; i <= last; i += step) {
@@ -254,46 +506,45 @@ struct spBaseTimeline* _spBaseTimeline_create (int framesCount, spTimelineType t
 static const int ROTATE_PREV_FRAME_TIME = -2;
 static const int ROTATE_FRAME_VALUE = 1;
 
-void _spRotateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha) {
-	spBone *bone;
-	int frameIndex;
-	float prevFrameValue, frameTime, percent, amount;
+/* Returns false if time is before the first frame, else sets the bone rotation the timeline keys at time. */
+static int _spRotateTimeline_getValue (const spRotateTimeline* self, const spBone* bone, float time, float* rotation) {
+	int frameIndex, curveIndex;
+	float prevFrameValue, frameTime, percent, amount, buffer[4];
+	const float* frames = _spCurveTimeline_findKey(SUPER(self), self->frames, self->framesCount, 2, time, buffer, &frameIndex,
+			&curveIndex);
 
-	spRotateTimeline* self = SUB_CAST(spRotateTimeline, timeline);
-
-	if (time < self->frames[0]) return; /* Time is before first frame. */
-
-	bone = skeleton->bones[self->boneIndex];
+	if (!frames) return 0; /* Time is before first frame. */
 
-	if (time >= self->frames[self->framesCount - 2]) { /* Time is after last frame. */
-		float amount = bone->data->rotation + self->frames[self->framesCount - 1] - bone->rotation;
-		while (amount > 180)
-			amount -= 360;
-		while (amount < -180)
-			amount += 360;
-		bone->rotation += amount * alpha;
-		return;
+	if (curveIndex == -1) { /* Time is after last frame. */
+		*rotation = bone->data->rotation + frames[frameIndex + ROTATE_FRAME_VALUE];
+		return 1;
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
-	frameIndex = binarySearch(self->frames, self->framesCount, time, 2);
-	prevFrameValue = self->frames[frameIndex - 1];
-	frameTime = self->frames[frameIndex];
-	percent = 1 - (time - frameTime) / (self->frames[frameIndex + ROTATE_PREV_FRAME_TIME] - frameTime);
-	percent = spCurveTimeline_getCurvePercent(SUPER(self), (frameIndex >> 1) - 1, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
-
-	amount = self->frames[frameIndex + ROTATE_FRAME_VALUE] - prevFrameValue;
-	while (amount > 180)
-		amount -= 360;
-	while (amount < -180)
-		amount += 360;
-	amount = bone->data->rotation + (prevFrameValue + amount * percent) - bone->rotation;
-	while (amount > 180)
-		amount -= 360;
-	while (amount < -180)
-		amount += 360;
-	bone->rotation += amount * alpha;
+	prevFrameValue = frames[frameIndex - 1];
+	frameTime = frames[frameIndex];
+	percent = 1 - (time - frameTime) / (frames[frameIndex + ROTATE_PREV_FRAME_TIME] - frameTime);
+	percent = spCurveTimeline_getCurvePercent(SUPER(self), curveIndex, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
+
+	amount = _spWrapDegrees(frames[frameIndex + ROTATE_FRAME_VALUE] - prevFrameValue);
+	*rotation = bone->data->rotation + (prevFrameValue + amount * percent);
+	return 1;
+}
+
+/* Returns rotation moved toward target by alpha, the short way around. */
+static float _mixRotation (float rotation, float target, float alpha) {
+	return rotation + _spWrapDegrees(target - rotation) * alpha;
+}
+
+void _spRotateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+		int* eventsCount, float alpha) {
+	spRotateTimeline* self = SUB_CAST(spRotateTimeline, timeline);
+	spBone* bone;
+	float rotation;
+	if (_isBonePruned(skeleton, self->boneIndex)) return;
+	bone = skeleton->bones[self->boneIndex];
+	if (!_spRotateTimeline_getValue(self, bone, time, &rotation)) return;
+	bone->rotation = _mixRotation(bone->rotation, rotation, alpha);
 }
 
 spRotateTimeline* spRotateTimeline_create (int framesCount) {
@@ -301,6 +552,7 @@ spRotateTimeline* spRotateTimeline_create (int framesCount) {
 }
 
 void spRotateTimeline_setFrame (spRotateTimeline* self, int frameIndex, float time, float angle) {
+	if (SUPER(self)->quantized) _spTimeline_dequantize(SUPER(SUPER(self)));
 	frameIndex *= 2;
 	self->frames[frameIndex] = time;
 	self->frames[frameIndex + 1] = angle;
@@ -312,36 +564,43 @@ static const int TRANSLATE_PREV_FRAME_TIME = -3;
 static const int TRANSLATE_FRAME_X = 1;
 static const int TRANSLATE_FRAME_Y = 2;
 
-void _spTranslateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha) {
-	spBone *bone;
-	int frameIndex;
-	float prevFrameX, prevFrameY, frameTime, percent;
-
-	spTranslateTimeline* self = SUB_CAST(spTranslateTimeline, timeline);
-
-	if (time < self->frames[0]) return; /* Time is before first frame. */
+/* Returns false if time is before the first frame, else sets the bone position the timeline keys at time. */
+static int _spTranslateTimeline_getValue (const spTranslateTimeline* self, const spBone* bone, float time, float* x, float* y) {
+	int frameIndex, curveIndex;
+	float prevFrameX, prevFrameY, frameTime, percent, buffer[6];
+	const float* frames = _spCurveTimeline_findKey(SUPER(self), self->frames, self->framesCount, 3, time, buffer, &frameIndex,
+			&curveIndex);
 
-	bone = skeleton->bones[self->boneIndex];
+	if (!frames) return 0; /* Time is before first frame. */
 
-	if (time >= self->frames[self->framesCount - 3]) { /* Time is after last frame. */
-		bone->x += (bone->data->x + self->frames[self->framesCount - 2] - bone->x) * alpha;
-		bone->y += (bone->data->y + self->frames[self->framesCount - 1] - bone->y) * alpha;
-		return;
+	if (curveIndex == -1) { /* Time is after last frame. */
+		*x = bone->data->x + frames[frameIndex + TRANSLATE_FRAME_X];
+		*y = bone->data->y + frames[frameIndex + TRANSLATE_FRAME_Y];
+		return 1;
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
-	frameIndex = binarySearch(self->frames, self->framesCount, time, 3);
-	prevFrameX = self->frames[frameIndex - 2];
-	prevFrameY = self->frames[frameIndex - 1];
-	frameTime = self->frames[frameIndex];
-	percent = 1 - (time - frameTime) / (self->frames[frameIndex + TRANSLATE_PREV_FRAME_TIME] - frameTime);
-	percent = spCurveTimeline_getCurvePercent(SUPER(self), frameIndex / 3 - 1, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
+	prevFrameX = frames[frameIndex - 2];
+	prevFrameY = frames[frameIndex - 1];
+	frameTime = frames[frameIndex];
+	percent = 1 - (time - frameTime) / (frames[frameIndex + TRANSLATE_PREV_FRAME_TIME] - frameTime);
+	percent = spCurveTimeline_getCurvePercent(SUPER(self), curveIndex, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
+
+	*x = bone->data->x + prevFrameX + (frames[frameIndex + TRANSLATE_FRAME_X] - prevFrameX) * percent;
+	*y = bone->data->y + prevFrameY + (frames[frameIndex + TRANSLATE_FRAME_Y] - prevFrameY) * percent;
+	return 1;
+}
 
-	bone->x += (bone->data->x + prevFrameX + (self->frames[frameIndex + TRANSLATE_FRAME_X] - prevFrameX) * percent - bone->x)
-			* alpha;
-	bone->y += (bone->data->y + prevFrameY + (self->frames[frameIndex + TRANSLATE_FRAME_Y] - prevFrameY) * percent - bone->y)
-			* alpha;
+void _spTranslateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
+		spEvent** firedEvents, int* eventsCount, float alpha) {
+	spTranslateTimeline* self = SUB_CAST(spTranslateTimeline, timeline);
+	spBone* bone;
+	float x, y;
+	if (_isBonePruned(skeleton, self->boneIndex)) return;
+	bone = skeleton->bones[self->boneIndex];
+	if (!_spTranslateTimeline_getValue(self, bone, time, &x, &y)) return;
+	bone->x += (x - bone->x) * alpha;
+	bone->y += (y - bone->y) * alpha;
 }
 
 spTranslateTimeline* spTranslateTimeline_create (int framesCount) {
@@ -349,6 +608,7 @@ spTranslateTimeline* spTranslateTimeline_create (int framesCount) {
 }
 
 void spTranslateTimeline_setFrame (spTranslateTimeline* self, int frameIndex, float time, float x, float y) {
+	if (SUPER(self)->quantized) _spTimeline_dequantize(SUPER(SUPER(self)));
 	frameIndex *= 3;
 	self->frames[frameIndex] = time;
 	self->frames[frameIndex + 1] = x;
@@ -357,35 +617,44 @@ void spTranslateTimeline_setFrame (spTranslateTimeline* self, int frameIndex, fl
 
 /**/
 
-void _spScaleTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha) {
-	spBone *bone;
-	int frameIndex;
-	float prevFrameX, prevFrameY, frameTime, percent;
-
-	spScaleTimeline* self = SUB_CAST(spScaleTimeline, timeline);
+/* Returns false if time is before the first frame, else sets the bone scale the timeline keys at time. */
+static int _spScaleTimeline_getValue (const spScaleTimeline* self, const spBone* bone, float time, float* scaleX,
+		float* scaleY) {
+	int frameIndex, curveIndex;
+	float prevFrameX, prevFrameY, frameTime, percent, buffer[6];
+	const float* frames = _spCurveTimeline_findKey(SUPER(self), self->frames, self->framesCount, 3, time, buffer, &frameIndex,
+			&curveIndex);
 
-	if (time < self->frames[0]) return; /* Time is before first frame. */
+	if (!frames) return 0; /* Time is before first frame. */
 
-	bone = skeleton->bones[self->boneIndex];
-	if (time >= self->frames[self->framesCount - 3]) { /* Time is after last frame. */
-		bone->scaleX += (bone->data->scaleX * self->frames[self->framesCount - 2] - bone->scaleX) * alpha;
-		bone->scaleY += (bone->data->scaleY * self->frames[self->framesCount - 1] - bone->scaleY) * alpha;
-		return;
+	if (curveIndex == -1) { /* Time is after last frame. */
+		*scaleX = bone->data->scaleX * frames[frameIndex + TRANSLATE_FRAME_X];
+		*scaleY = bone->data->scaleY * frames[frameIndex + TRANSLATE_FRAME_Y];
+		return 1;
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
-	frameIndex = binarySearch(self->frames, self->framesCount, time, 3);
-	prevFrameX = self->frames[frameIndex - 2];
-	prevFrameY = self->frames[frameIndex - 1];
-	frameTime = self->frames[frameIndex];
-	percent = 1 - (time - frameTime) / (self->frames[frameIndex + TRANSLATE_PREV_FRAME_TIME] - frameTime);
-	percent = spCurveTimeline_getCurvePercent(SUPER(self), frameIndex / 3 - 1, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
+	prevFrameX = frames[frameIndex - 2];
+	prevFrameY = frames[frameIndex - 1];
+	frameTime = frames[frameIndex];
+	percent = 1 - (time - frameTime) / (frames[frameIndex + TRANSLATE_PREV_FRAME_TIME] - frameTime);
+	percent = spCurveTimeline_getCurvePercent(SUPER(self), curveIndex, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
+
+	*scaleX = bone->data->scaleX * (prevFrameX + (frames[frameIndex + TRANSLATE_FRAME_X] - prevFrameX) * percent);
+	*scaleY = bone->data->scaleY * (prevFrameY + (frames[frameIndex + TRANSLATE_FRAME_Y] - prevFrameY) * percent);
+	return 1;
+}
 
-	bone->scaleX += (bone->data->scaleX * (prevFrameX + (self->frames[frameIndex + TRANSLATE_FRAME_X] - prevFrameX) * percent)
-			- bone->scaleX) * alpha;
-	bone->scaleY += (bone->data->scaleY * (prevFrameY + (self->frames[frameIndex + TRANSLATE_FRAME_Y] - prevFrameY) * percent)
-			- bone->scaleY) * alpha;
+void _spScaleTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+		int* eventsCount, float alpha) {
+	spScaleTimeline* self = SUB_CAST(spScaleTimeline, timeline);
+	spBone* bone;
+	float scaleX, scaleY;
+	if (_isBonePruned(skeleton, self->boneIndex)) return;
+	bone = skeleton->bones[self->boneIndex];
+	if (!_spScaleTimeline_getValue(self, bone, time, &scaleX, &scaleY)) return;
+	bone->scaleX += (scaleX - bone->scaleX) * alpha;
+	bone->scaleY += (scaleY - bone->scaleY) * alpha;
 }
 
 spScaleTimeline* spScaleTimeline_create (int framesCount) {
@@ -404,58 +673,67 @@ static const int COLOR_FRAME_G = 2;
 static const int COLOR_FRAME_B = 3;
 static const int COLOR_FRAME_A = 4;
 
-void _spColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-		int* eventsCount, float alpha) {
-	spSlot *slot;
-	int frameIndex;
-	float prevFrameR, prevFrameG, prevFrameB, prevFrameA, percent, frameTime;
-	float r, g, b, a;
-	spColorTimeline* self = (spColorTimeline*)timeline;
+/* Returns false if time is before the first frame, else sets the r, g, b, a the timeline keys at time. */
+static int _spColorTimeline_getValue (const spColorTimeline* self, float time, float* color) {
+	int frameIndex, curveIndex;
+	float prevFrameR, prevFrameG, prevFrameB, prevFrameA, percent, frameTime, buffer[10];
+	const float* frames = _spCurveTimeline_findKey(SUPER(self), self->frames, self->framesCount, 5, time, buffer, &frameIndex,
+			&curveIndex);
 
-	if (time < self->frames[0]) return; /* Time is before first frame. */
+	if (!frames) return 0; /* Time is before first frame. */
 
-	if (time >= self->frames[self->framesCount - 5]) {
+	if (curveIndex == -1) {
 		/* Time is after last frame. */
-		int i = self->framesCount - 1;
-		r = self->frames[i - 3];
-		g = self->frames[i - 2];
-		b = self->frames[i - 1];
-		a = self->frames[i];
+		color[0] = frames[frameIndex + COLOR_FRAME_R];
+		color[1] = frames[frameIndex + COLOR_FRAME_G];
+		color[2] = frames[frameIndex + COLOR_FRAME_B];
+		color[3] = frames[frameIndex + COLOR_FRAME_A];
 	} else {
 		/* Interpolate between the previous frame and the current frame. */
-		frameIndex = binarySearch(self->frames, self->framesCount, time, 5);
-		prevFrameR = self->frames[frameIndex - 4];
-		prevFrameG = self->frames[frameIndex - 3];
-		prevFrameB = self->frames[frameIndex - 2];
-		prevFrameA = self->frames[frameIndex - 1];
-		frameTime = self->frames[frameIndex];
-		percent = 1 - (time - frameTime) / (self->frames[frameIndex + COLOR_PREV_FRAME_TIME] - frameTime);
-		percent = spCurveTimeline_getCurvePercent(SUPER(self), frameIndex / 5 - 1, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
-
-		r = prevFrameR + (self->frames[frameIndex + COLOR_FRAME_R] - prevFrameR) * percent;
-		g = prevFrameG + (self->frames[frameIndex + COLOR_FRAME_G] - prevFrameG) * percent;
-		b = prevFrameB + (self->frames[frameIndex + COLOR_FRAME_B] - prevFrameB) * percent;
-		a = prevFrameA + (self->frames[frameIndex + COLOR_FRAME_A] - prevFrameA) * percent;
-	}
-	slot = skeleton->slots[self->slotIndex];
+		prevFrameR = frames[frameIndex - 4];
+		prevFrameG = frames[frameIndex - 3];
+		prevFrameB = frames[frameIndex - 2];
+		prevFrameA = frames[frameIndex - 1];
+		frameTime = frames[frameIndex];
+		percent = 1 - (time - frameTime) / (frames[frameIndex + COLOR_PREV_FRAME_TIME] - frameTime);
+		percent = spCurveTimeline_getCurvePercent(SUPER(self), curveIndex, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
+
+		color[0] = prevFrameR + (frames[frameIndex + COLOR_FRAME_R] - prevFrameR) * percent;
+		color[1] = prevFrameG + (frames[frameIndex + COLOR_FRAME_G] - prevFrameG) * percent;
+		color[2] = prevFrameB + (frames[frameIndex + COLOR_FRAME_B] - prevFrameB) * percent;
+		color[3] = prevFrameA + (frames[frameIndex + COLOR_FRAME_A] - prevFrameA) * percent;
+	}
+	return 1;
+}
+
+static void _spSlot_mixColor (spSlot* slot, const float* color, float alpha) {
 	if (alpha < 1) {
-		slot->r += (r - slot->r) * alpha;
-		slot->g += (g - slot->g) * alpha;
-		slot->b += (b - slot->b) * alpha;
-		slot->a += (a - slot->a) * alpha;
+		slot->r += (color[0] - slot->r) * alpha;
+		slot->g += (color[1] - slot->g) * alpha;
+		slot->b += (color[2] - slot->b) * alpha;
+		slot->a += (color[3] - slot->a) * alpha;
 	} else {
-		slot->r = r;
-		slot->g = g;
-		slot->b = b;
-		slot->a = a;
+		slot->r = color[0];
+		slot->g = color[1];
+		slot->b = color[2];
+		slot->a = color[3];
 	}
 }
 
+void _spColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+		int* eventsCount, float alpha) {
+	spColorTimeline* self = (spColorTimeline*)timeline;
+	float color[4];
+	if (!_spColorTimeline_getValue(self, time, color)) return;
+	_spSlot_mixColor(skeleton->slots[self->slotIndex], color, alpha);
+}
+
 spColorTimeline* spColorTimeline_create (int framesCount) {
 	return (spColorTimeline*)_spBaseTimeline_create(framesCount, SP_TIMELINE_COLOR, 5, _spColorTimeline_apply);
 }
 
 void spColorTimeline_setFrame (spColorTimeline* self, int frameIndex, float time, float r, float g, float b, float a) {
+	if (SUPER(self)->quantized) _spTimeline_dequantize(SUPER(SUPER(self)));
 	frameIndex *= 5;
 	self->frames[frameIndex] = time;
 	self->frames[frameIndex + 1] = r;
@@ -649,12 +927,26 @@ void spDrawOrderTimeline_setFrame (spDrawOrderTimeline* self, int frameIndex, fl
 
 /**/
 
+/* Moves the vertices in [start, end) toward the setup vertices by alpha. */
+static void _spFFDTimeline_reset (float* vertices, const float* setupVertices, int start, int end, float alpha) {
+	int i;
+	if (alpha < 1) {
+		for (i = start; i < end; ++i)
+			vertices[i] += ((setupVertices ? setupVertices[i] : 0) - vertices[i]) * alpha;
+	} else if (setupVertices)
+		memcpy(vertices + start, setupVertices + start, (end - start) * sizeof(float));
+	else
+		memset(vertices + start, 0, (end - start) * sizeof(float));
+}
+
 void _spFFDTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 		int* eventsCount, float alpha) {
-	int frameIndex, i;
+	int frameIndex, i, deformedStart, deformedEnd, prevOffset, prevCount, nextOffset, nextCount;
 	float percent, frameTime;
 	const float* prevVertices;
 	const float* nextVertices;
+	/* The vertices frames are relative to: a mesh's vertices, or 0 for a skinned mesh's weighted positions. */
+	const float* setupVertices;
 	spFFDTimeline* self = (spFFDTimeline*)timeline;
 
 	spSlot *slot = skeleton->slots[self->slotIndex];
@@ -669,17 +961,47 @@ void _spFFDTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, flo
 			slot->attachmentVerticesCapacity = self->frameVerticesCount;
 		}
 	}
-	if (slot->attachmentVerticesCount != self->frameVerticesCount) alpha = 1; /* Don't mix from uninitialized slot vertices. */
+	if (slot->attachmentVerticesCount != self->frameVerticesCount) {
+		alpha = 1; /* Don't mix from uninitialized slot vertices. */
+		deformedStart = 0;
+		deformedEnd = self->frameVerticesCount;
+	} else
+		_spSlot_getDeformedRange(slot, &deformedStart, &deformedEnd);
 	slot->attachmentVerticesCount = self->frameVerticesCount;
+	slot->attachmentVerticesVersion++;
+
+	setupVertices = self->attachment->type == SP_ATTACHMENT_MESH ? SUB_CAST(spMeshAttachment, self->attachment)->vertices : 0;
+
+	/* Vertices no frame keys are the setup vertices, only those another timeline deformed need to be written. */
+	if (deformedStart < deformedEnd) {
+		if (deformedStart < self->keyedStart)
+			_spFFDTimeline_reset(slot->attachmentVertices, setupVertices, deformedStart,
+					deformedEnd < self->keyedStart ? deformedEnd : self->keyedStart, alpha);
+		if (deformedEnd > self->keyedEnd)
+			_spFFDTimeline_reset(slot->attachmentVertices, setupVertices,
+					deformedStart > self->keyedEnd ? deformedStart : self->keyedEnd, deformedEnd, alpha);
+	}
+	if (alpha < 1 && deformedStart < deformedEnd) {
+		if (self->keyedStart < self->keyedEnd) {
+			if (self->keyedStart < deformedStart) deformedStart = self->keyedStart;
+			if (self->keyedEnd > deformedEnd) deformedEnd = self->keyedEnd;
+		}
+		_spSlot_setDeformedRange(slot, deformedStart, deformedEnd);
+	} else
+		_spSlot_setDeformedRange(slot, self->keyedStart, self->keyedEnd);
 
 	if (time >= self->frames[self->framesCount - 1]) {
 		/* Time is after last frame. */
 		const float* lastVertices = self->frameVertices[self->framesCount - 1];
-		if (alpha < 1) {
-			for (i = 0; i < self->frameVerticesCount; ++i)
-				slot->attachmentVertices[i] += (lastVertices[i] - slot->attachmentVertices[i]) * alpha;
-		} else
-			memcpy(slot->attachmentVertices, lastVertices, self->frameVerticesCount * sizeof(float));
+		int lastOffset = self->frameOffsets[self->framesCount - 1], lastCount = self->frameCounts[self->framesCount - 1];
+		for (i = self->keyedStart; i < self->keyedEnd; ++i) {
+			float last = setupVertices ? setupVertices[i] : 0;
+			if ((unsigned int)(i - lastOffset) < (unsigned int)lastCount) last += lastVertices[i - lastOffset];
+			if (alpha < 1)
+				slot->attachmentVertices[i] += (last - slot->attachmentVertices[i]) * alpha;
+			else
+				slot->attachmentVertices[i] = last;
+		}
 		return;
 	}
 
@@ -690,18 +1012,20 @@ void _spFFDTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, flo
 	percent = spCurveTimeline_getCurvePercent(SUPER(self), frameIndex - 1, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
 
 	prevVertices = self->frameVertices[frameIndex - 1];
+	prevOffset = self->frameOffsets[frameIndex - 1];
+	prevCount = self->frameCounts[frameIndex - 1];
 	nextVertices = self->frameVertices[frameIndex];
-
-	if (alpha < 1) {
-		for (i = 0; i < self->frameVerticesCount; ++i) {
-			float prev = prevVertices[i];
-			slot->attachmentVertices[i] += (prev + (nextVertices[i] - prev) * percent - slot->attachmentVertices[i]) * alpha;
-		}
-	} else {
-		for (i = 0; i < self->frameVerticesCount; ++i) {
-			float prev = prevVertices[i];
-			slot->attachmentVertices[i] = prev + (nextVertices[i] - prev) * percent;
-		}
+	nextOffset = self->frameOffsets[frameIndex];
+	nextCount = self->frameCounts[frameIndex];
+
+	for (i = self->keyedStart; i < self->keyedEnd; ++i) {
+		float prev = setupVertices ? setupVertices[i] : 0, next = prev;
+		if ((unsigned int)(i - prevOffset) < (unsigned int)prevCount) prev += prevVertices[i - prevOffset];
+		if ((unsigned int)(i - nextOffset) < (unsigned int)nextCount) next += nextVertices[i - nextOffset];
+		if (alpha < 1)
+			slot->attachmentVertices[i] += (prev + (next - prev) * percent - slot->attachmentVertices[i]) * alpha;
+		else
+			slot->attachmentVertices[i] = prev + (next - prev) * percent;
 	}
 }
 
@@ -714,6 +1038,8 @@ void _spFFDTimeline_dispose (spTimeline* timeline) {
 	for (i = 0; i < self->framesCount; ++i)
 		FREE(self->frameVertices[i]);
 	FREE(self->frameVertices);
+	FREE(self->frameOffsets);
+	FREE(self->frameCounts);
 	FREE(self->frames);
 	FREE(self);
 }
@@ -724,20 +1050,56 @@ spFFDTimeline* spFFDTimeline_create (int framesCount, int frameVerticesCount) {
 	CONST_CAST(int, self->framesCount) = framesCount;
 	CONST_CAST(float*, self->frames) = CALLOC(float, self->framesCount);
 	CONST_CAST(float**, self->frameVertices) = CALLOC(float*, framesCount);
+	CONST_CAST(int*, self->frameOffsets) = CALLOC(int, framesCount);
+	CONST_CAST(int*, self->frameCounts) = CALLOC(int, framesCount);
 	CONST_CAST(int, self->frameVerticesCount) = frameVerticesCount;
 	return self;
 }
 
-void spFFDTimeline_setFrame (spFFDTimeline* self, int frameIndex, float time, float* vertices) {
+void spFFDTimeline_setSparseFrame (spFFDTimeline* self, int frameIndex, float time, int offset, int count,
+		const float* vertexOffsets) {
 	self->frames[frameIndex] = time;
 
+	/* Zeros at either end keep the setup vertices, so they aren't stored. */
+	while (count > 0 && vertexOffsets[0] == 0) {
+		vertexOffsets++;
+		offset++;
+		count--;
+	}
+	while (count > 0 && vertexOffsets[count - 1] == 0)
+		count--;
+
 	FREE(self->frameVertices[frameIndex]);
-	if (!vertices)
-		self->frameVertices[frameIndex] = 0;
-	else {
-		self->frameVertices[frameIndex] = MALLOC(float, self->frameVerticesCount);
-		memcpy(CONST_CAST(float*, self->frameVertices[frameIndex]), vertices, self->frameVerticesCount * sizeof(float));
+	self->frameVertices[frameIndex] = 0;
+	CONST_CAST(int*, self->frameOffsets)[frameIndex] = offset;
+	CONST_CAST(int*, self->frameCounts)[frameIndex] = count;
+	if (!count) return;
+	self->frameVertices[frameIndex] = MALLOC(float, count);
+	memcpy(CONST_CAST(float*, self->frameVertices[frameIndex]), vertexOffsets, count * sizeof(float));
+
+	/* Replaced frames only ever shrink the keyed range, which is kept as it was. */
+	if (self->keyedStart == self->keyedEnd) {
+		CONST_CAST(int, self->keyedStart) = offset;
+		CONST_CAST(int, self->keyedEnd) = offset + count;
+	} else {
+		if (offset < self->keyedStart) CONST_CAST(int, self->keyedStart) = offset;
+		if (offset + count > self->keyedEnd) CONST_CAST(int, self->keyedEnd) = offset + count;
+	}
+}
+
+void spFFDTimeline_setFrame (spFFDTimeline* self, int frameIndex, float time, float* vertices) {
+	float* vertexOffsets;
+	int i;
+	if (!vertices) {
+		spFFDTimeline_setSparseFrame(self, frameIndex, time, 0, 0, 0);
+		return;
 	}
+	vertexOffsets = MALLOC(float, self->frameVerticesCount);
+	for (i = 0; i < self->frameVerticesCount; ++i)
+		vertexOffsets[i] = self->attachment->type == SP_ATTACHMENT_MESH ?
+				vertices[i] - SUB_CAST(spMeshAttachment, self->attachment)->vertices[i] : vertices[i];
+	spFFDTimeline_setSparseFrame(self, frameIndex, time, 0, self->frameVerticesCount, vertexOffsets);
+	FREE(vertexOffsets);
 }
 
 
@@ -748,21 +1110,17 @@ static const int IKCONSTRAINT_PREV_FRAME_MIX = -2;
 static const int IKCONSTRAINT_PREV_FRAME_BEND_DIRECTION = -1;
 static const int IKCONSTRAINT_FRAME_MIX = 1;
 
-void _spIkConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
-		spEvent** firedEvents, int* eventsCount, float alpha) {
+/* Returns false if time is before the first frame, else sets the mix and bend direction the timeline keys at time. */
+static int _spIkConstraintTimeline_getValue (const spIkConstraintTimeline* self, float time, float* mix, int* bendDirection) {
 	int frameIndex;
-	float prevFrameMix, frameTime, percent, mix;
-	spIkConstraint* ikConstraint;
-	spIkConstraintTimeline* self = (spIkConstraintTimeline*)timeline;
-
-	if (time < self->frames[0]) return; /* Time is before first frame. */
+	float prevFrameMix, frameTime, percent;
 
-	ikConstraint = skeleton->ikConstraints[self->ikConstraintIndex];
+	if (time < self->frames[0]) return 0; /* Time is before first frame. */
 
 	if (time >= self->frames[self->framesCount - 3]) { /* Time is after last frame. */
-		ikConstraint->mix += (self->frames[self->framesCount - 2] - ikConstraint->mix) * alpha;
-		ikConstraint->bendDirection = (int)self->frames[self->framesCount - 1];
-		return;
+		*mix = self->frames[self->framesCount - 2];
+		*bendDirection = (int)self->frames[self->framesCount - 1];
+		return 1;
 	}
 
 	/* Interpolate between the previous frame and the current frame. */
@@ -772,9 +1130,20 @@ void _spIkConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skel
 	percent = 1 - (time - frameTime) / (self->frames[frameIndex + IKCONSTRAINT_PREV_FRAME_TIME] - frameTime);
 	percent = spCurveTimeline_getCurvePercent(SUPER(self), frameIndex / 3 - 1, percent < 0 ? 0 : (percent > 1 ? 1 : percent));
 
-	mix = prevFrameMix + (self->frames[frameIndex + IKCONSTRAINT_FRAME_MIX] - prevFrameMix) * percent;
+	*mix = prevFrameMix + (self->frames[frameIndex + IKCONSTRAINT_FRAME_MIX] - prevFrameMix) * percent;
+	*bendDirection = (int)self->frames[frameIndex + IKCONSTRAINT_PREV_FRAME_BEND_DIRECTION];
+	return 1;
+}
+
+void _spIkConstraintTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
+		spEvent** firedEvents, int* eventsCount, float alpha) {
+	spIkConstraintTimeline* self = (spIkConstraintTimeline*)timeline;
+	spIkConstraint* ikConstraint = skeleton->ikConstraints[self->ikConstraintIndex];
+	float mix;
+	int bendDirection;
+	if (!_spIkConstraintTimeline_getValue(self, time, &mix, &bendDirection)) return;
 	ikConstraint->mix += (mix - ikConstraint->mix) * alpha;
-	ikConstraint->bendDirection = (int)self->frames[frameIndex + IKCONSTRAINT_PREV_FRAME_BEND_DIRECTION];
+	ikConstraint->bendDirection = bendDirection;
 }
 
 spIkConstraintTimeline* spIkConstraintTimeline_create (int framesCount) {
@@ -795,6 +1164,7 @@ void _spFlipTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, fl
 	int frameIndex;
 	spFlipTimeline* self = (spFlipTimeline*)timeline;
 
+	if (_isBonePruned(skeleton, self->boneIndex)) return;
 	if (time < self->frames[0]) {
 		if (lastTime > time) _spFlipTimeline_apply(timeline, skeleton, lastTime, (float)INT_MAX, 0, 0, 0);
 		return;
@@ -834,3 +1204,397 @@ void spFlipTimeline_setFrame (spFlipTimeline* self, int frameIndex, float time,
 }
 
 /**/
+
+/**/
+
+int _spAnimation_pairTimelines (const spAnimation* from, const spAnimation* to, const spSkeletonData* skeletonData, int* pairs) {
+	int i = 0, ii = 0;
+	int* fromPaired = pairs + to->timelinesCount;
+	if (!from->maskedTimelines || !to->maskedTimelines) return 0;
+
+	for (i = 0; i < to->timelinesCount; ++i)
+		pairs[i] = -1;
+	memset(fromPaired, 0, from->timelinesCount * sizeof(int));
+
+	/* Merge join of the masked timelines, which are ordered by their property. */
+	i = 0;
+	while (i < from->maskedTimelinesCount && ii < to->maskedTimelinesCount) {
+		int fromIndex = from->maskedTimelines[i], toIndex = to->maskedTimelines[ii];
+		int fromProperty = _spTimeline_getMaskIndex(from->timelines[fromIndex], skeletonData);
+		int toProperty = _spTimeline_getMaskIndex(to->timelines[toIndex], skeletonData);
+		if (fromProperty < toProperty)
+			++i;
+		else if (fromProperty > toProperty)
+			++ii;
+		else {
+			pairs[toIndex] = fromIndex;
+			fromPaired[fromIndex] = 1;
+			++i;
+			++ii;
+		}
+	}
+	return 1;
+}
+
+/* Applies a pair of blendable timelines for the same property, as if from were applied with full alpha and then to mixed with
+ * alpha, but writing the property once. */
+static void _spTimeline_crossfade (const spTimeline* from, float fromTime, const spTimeline* to, spSkeleton* skeleton,
+		float time, float alpha) {
+	float from0, from1, to0, to1;
+	switch (to->type) {
+	case SP_TIMELINE_ROTATE: {
+		spBone* bone = skeleton->bones[SUB_CAST(spRotateTimeline, to)->boneIndex];
+		float rotation = bone->rotation;
+		if (_spRotateTimeline_getValue(SUB_CAST(spRotateTimeline, from), bone, fromTime, &from0))
+			rotation = _mixRotation(rotation, from0, 1);
+		if (_spRotateTimeline_getValue(SUB_CAST(spRotateTimeline, to), bone, time, &to0))
+			rotation = _mixRotation(rotation, to0, alpha);
+		bone->rotation = rotation;
+		break;
+	}
+	case SP_TIMELINE_TRANSLATE: {
+		spBone* bone = skeleton->bones[SUB_CAST(spTranslateTimeline, to)->boneIndex];
+		float x = bone->x, y = bone->y;
+		if (_spTranslateTimeline_getValue(SUB_CAST(spTranslateTimeline, from), bone, fromTime, &from0, &from1)) {
+			x += from0 - x;
+			y += from1 - y;
+		}
+		if (_spTranslateTimeline_getValue(SUB_CAST(spTranslateTimeline, to), bone, time, &to0, &to1)) {
+			x += (to0 - x) * alpha;
+			y += (to1 - y) * alpha;
+		}
+		bone->x = x;
+		bone->y = y;
+		break;
+	}
+	case SP_TIMELINE_SCALE: {
+		spBone* bone = skeleton->bones[SUB_CAST(spScaleTimeline, to)->boneIndex];
+		float scaleX = bone->scaleX, scaleY = bone->scaleY;
+		if (_spScaleTimeline_getValue(SUB_CAST(spScaleTimeline, from), bone, fromTime, &from0, &from1)) {
+			scaleX += from0 - scaleX;
+			scaleY += from1 - scaleY;
+		}
+		if (_spScaleTimeline_getValue(SUB_CAST(spScaleTimeline, to), bone, time, &to0, &to1)) {
+			scaleX += (to0 - scaleX) * alpha;
+			scaleY += (to1 - scaleY) * alpha;
+		}
+		bone->scaleX = scaleX;
+		bone->scaleY = scaleY;
+		break;
+	}
+	case SP_TIMELINE_COLOR: {
+		spSlot* slot = skeleton->slots[SUB_CAST(spColorTimeline, to)->slotIndex];
+		float fromColor[4], toColor[4];
+		int hasFrom = _spColorTimeline_getValue(SUB_CAST(spColorTimeline, from), fromTime, fromColor);
+		if (_spColorTimeline_getValue(SUB_CAST(spColorTimeline, to), time, toColor)) {
+			if (hasFrom && alpha < 1) {
+				toColor[0] = fromColor[0] + (toColor[0] - fromColor[0]) * alpha;
+				toColor[1] = fromColor[1] + (toColor[1] - fromColor[1]) * alpha;
+				toColor[2] = fromColor[2] + (toColor[2] - fromColor[2]) * alpha;
+				toColor[3] = fromColor[3] + (toColor[3] - fromColor[3]) * alpha;
+				alpha = 1;
+			}
+			_spSlot_mixColor(slot, toColor, alpha);
+		} else if (hasFrom)
+			_spSlot_mixColor(slot, fromColor, 1);
+		break;
+	}
+	case SP_TIMELINE_IKCONSTRAINT: {
+		spIkConstraint* ikConstraint = skeleton->ikConstraints[SUB_CAST(spIkConstraintTimeline, to)->ikConstraintIndex];
+		float mix = ikConstraint->mix;
+		int bendDirection = ikConstraint->bendDirection;
+		if (_spIkConstraintTimeline_getValue(SUB_CAST(spIkConstraintTimeline, from), fromTime, &from0, &bendDirection))
+			mix += from0 - mix;
+		if (_spIkConstraintTimeline_getValue(SUB_CAST(spIkConstraintTimeline, to), time, &to0, &bendDirection))
+			mix += (to0 - mix) * alpha;
+		ikConstraint->mix = mix;
+		ikConstraint->bendDirection = bendDirection;
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+int _spAnimation_crossfade (const spAnimation* from, float fromTime, int fromLoop, const spAnimation* self, spSkeleton* skeleton,
+		float lastTime, float time, int loop, spEvent** events, int* eventsCount, float alpha, const unsigned int* skipMask,
+		const unsigned int* bonesMask, const int* pairs) {
+	int i;
+	const int* fromPaired;
+
+	if (!pairs) return 0;
+	fromPaired = pairs + self->timelinesCount;
+
+	if (fromLoop && from->duration) fromTime = FMOD(fromTime, from->duration);
+	if (loop && self->duration) {
+		time = FMOD(time, self->duration);
+		lastTime = FMOD(lastTime, self->duration);
+	}
+
+	/* A paired property is only keyed by its two timelines, so applying the pair where the timeline of self is keeps the order
+	 * of everything else the same as applying from and then self. */
+	for (i = 0; i < from->timelinesCount; ++i) {
+		const spTimeline* timeline = from->timelines[i];
+		if (fromPaired[i] || _spTimeline_isMasked(timeline, skeleton->data, skipMask, bonesMask)) continue;
+		spTimeline_apply(timeline, skeleton, fromTime, fromTime, 0, 0, 1);
+	}
+	for (i = 0; i < self->timelinesCount; ++i) {
+		const spTimeline* timeline = self->timelines[i];
+		if (_spTimeline_isMasked(timeline, skeleton->data, skipMask, bonesMask)) continue;
+		if (pairs[i] == -1)
+			spTimeline_apply(timeline, skeleton, lastTime, time, events, eventsCount, alpha);
+		else if (!_spTimeline_isPruned(timeline, skeleton))
+			_spTimeline_crossfade(from->timelines[pairs[i]], fromTime, timeline, skeleton, time, alpha);
+	}
+	return 1;
+}
+
+/**/
+
+/* Returns how far value b is from value a, the short way around for rotations. */
+static float _spReduce_difference (float a, float b, int/*bool*/rotate) {
+	return rotate ? _spWrapDegrees(b - a) : b - a;
+}
+
+/* Returns true if keys (from, to] all hold the values of key from. */
+static int _spReduce_isHeld (const float* frames, int entrySize, int/*bool*/rotate, int/*bool*/discreteLast, int from, int to,
+		float tolerance) {
+	int i, ii, valuesCount = discreteLast ? entrySize - 2 : entrySize - 1;
+	const float* start = frames + from * entrySize;
+	for (i = from + 1; i <= to; ++i) {
+		const float* key = frames + i * entrySize;
+		for (ii = 1; ii <= valuesCount; ++ii)
+			if (FABS(_spReduce_difference(start[ii], key[ii], rotate)) > tolerance) return 0;
+		if (discreteLast && key[entrySize - 1] != start[entrySize - 1]) return 0;
+	}
+	return 1;
+}
+
+/* Returns true if linear interpolation from key from to key to reproduces the keys between them. */
+static int _spReduce_isLinear (const float* frames, const float* curves, int entrySize, int/*bool*/rotate,
+		int/*bool*/discreteLast, int from, int to, float tolerance) {
+	int i, ii, valuesCount = discreteLast ? entrySize - 2 : entrySize - 1;
+	const float* start = frames + from * entrySize;
+	const float* end = frames + to * entrySize;
+	if (end[0] <= start[0]) return 0;
+	for (i = from; i < to; ++i) {
+		if (curves[i * BEZIER_SIZE] != CURVE_LINEAR) return 0;
+		/* Discrete values are held until the next key. */
+		if (discreteLast && frames[i * entrySize + entrySize - 1] != start[entrySize - 1]) return 0;
+	}
+	for (ii = 1; ii <= valuesCount; ++ii) {
+		float amount = _spReduce_difference(start[ii], end[ii], rotate), sum = 0;
+		for (i = from + 1; i <= to; ++i) {
+			const float* key = frames + i * entrySize;
+			/* Rotations interpolate each key to the next the short way around, so the sum must match too. */
+			sum += _spReduce_difference(key[ii - entrySize], key[ii], rotate);
+			if (FABS(sum - amount * (key[0] - start[0]) / (end[0] - start[0])) > tolerance) return 0;
+		}
+	}
+	return 1;
+}
+
+/* Rebuilds the frames and curves without the keys the remaining keys reproduce within tolerance. */
+static void _spCurveTimeline_reduce (spCurveTimeline* self, int* framesCount, float** frames, int entrySize, int/*bool*/rotate,
+		int/*bool*/discreteLast, float tolerance) {
+	const float* from = *frames;
+	const float* fromCurves = self->curves;
+	int keysCount = *framesCount / entrySize, i, previous = 0, n = 1, stepped = 0;
+	float *to, *toCurves;
+	if (keysCount < 2 || self->quantized) return;
+
+	to = MALLOC(float, *framesCount);
+	toCurves = CALLOC(float, (keysCount - 1) * BEZIER_SIZE);
+	memcpy(to, from, entrySize * sizeof(float));
+	for (i = 1; i < keysCount; ++i) {
+		if (_spReduce_isHeld(from, entrySize, rotate, discreteLast, previous, i, tolerance)) {
+			/* Values after the last key are held, so trailing keys that don't change the value aren't needed. */
+			if (i == keysCount - 1) break;
+			/* Stepping from a held value is the same as stepping from the previous key. */
+			if (fromCurves[i * BEZIER_SIZE] == CURVE_STEPPED) {
+				stepped = 1;
+				continue;
+			}
+		}
+		if (!stepped && i < keysCount - 1
+				&& _spReduce_isLinear(from, fromCurves, entrySize, rotate, discreteLast, previous, i + 1, tolerance)) continue;
+
+		memcpy(toCurves + (n - 1) * BEZIER_SIZE, fromCurves + previous * BEZIER_SIZE, BEZIER_SIZE * sizeof(float));
+		if (stepped) toCurves[(n - 1) * BEZIER_SIZE] = CURVE_STEPPED;
+		memcpy(to + n * entrySize, from + i * entrySize, entrySize * sizeof(float));
+		previous = i;
+		stepped = 0;
+		n++;
+	}
+
+	if (n == keysCount) {
+		FREE(to);
+		FREE(toCurves);
+		return;
+	}
+	*framesCount = n * entrySize;
+	*frames = MALLOC(float, n * entrySize);
+	memcpy(*frames, to, n * entrySize * sizeof(float));
+	FREE(from);
+	FREE(to);
+	FREE(self->curves);
+	self->curves = toCurves;
+}
+
+/* Returns true if the timeline keys only the setup pose. */
+static int _spTimeline_isSetupPose (const spTimeline* self, const spSkeletonData* skeletonData, const float* frames,
+		int framesCount, float tolerance) {
+	if (!frames) return 0; /* Quantized. */
+	switch (self->type) {
+	case SP_TIMELINE_ROTATE:
+		return framesCount == 2 && FABS(_spWrapDegrees(frames[1])) <= tolerance;
+	case SP_TIMELINE_TRANSLATE:
+		return framesCount == 3 && FABS(frames[1]) <= tolerance && FABS(frames[2]) <= tolerance;
+	case SP_TIMELINE_SCALE:
+		return framesCount == 3 && FABS(frames[1] - 1) <= tolerance && FABS(frames[2] - 1) <= tolerance;
+	case SP_TIMELINE_COLOR: {
+		const spSlotData* slot = skeletonData->slots[SUB_CAST(spColorTimeline, self)->slotIndex];
+		return framesCount == 5 && FABS(frames[1] - slot->r) <= tolerance && FABS(frames[2] - slot->g) <= tolerance
+				&& FABS(frames[3] - slot->b) <= tolerance && FABS(frames[4] - slot->a) <= tolerance;
+	}
+	case SP_TIMELINE_IKCONSTRAINT: {
+		const spIkConstraintData* ikConstraint =
+				skeletonData->ikConstraints[SUB_CAST(spIkConstraintTimeline, self)->ikConstraintIndex];
+		return framesCount == 3 && FABS(frames[1] - ikConstraint->mix) <= tolerance && frames[2] == ikConstraint->bendDirection;
+	}
+	default:
+		return 0;
+	}
+}
+
+void spAnimation_reduceKeys (spAnimation* self, const spSkeletonData* skeletonData, float tolerance,
+		int/*bool*/removeSetupPose) {
+	int i, n;
+	for (i = 0, n = 0; i < self->timelinesCount; ++i) {
+		spTimeline* timeline = self->timelines[i];
+		int* framesCount;
+		float** frames;
+		switch (timeline->type) {
+		case SP_TIMELINE_ROTATE:
+		case SP_TIMELINE_TRANSLATE:
+		case SP_TIMELINE_SCALE:
+			framesCount = &CONST_CAST(int, SUB_CAST(spBaseTimeline, timeline)->framesCount);
+			frames = &CONST_CAST(float*, SUB_CAST(spBaseTimeline, timeline)->frames);
+			_spCurveTimeline_reduce(SUPER(SUB_CAST(spBaseTimeline, timeline)), framesCount, frames,
+					timeline->type == SP_TIMELINE_ROTATE ? 2 : 3, timeline->type == SP_TIMELINE_ROTATE, 0, tolerance);
+			break;
+		case SP_TIMELINE_COLOR:
+			framesCount = &CONST_CAST(int, SUB_CAST(spColorTimeline, timeline)->framesCount);
+			frames = &CONST_CAST(float*, SUB_CAST(spColorTimeline, timeline)->frames);
+			_spCurveTimeline_reduce(SUPER(SUB_CAST(spColorTimeline, timeline)), framesCount, frames, 5, 0, 0, tolerance);
+			break;
+		case SP_TIMELINE_IKCONSTRAINT:
+			framesCount = &CONST_CAST(int, SUB_CAST(spIkConstraintTimeline, timeline)->framesCount);
+			frames = &CONST_CAST(float*, SUB_CAST(spIkConstraintTimeline, timeline)->frames);
+			_spCurveTimeline_reduce(SUPER(SUB_CAST(spIkConstraintTimeline, timeline)), framesCount, frames, 3, 0, 1, tolerance);
+			break;
+		default:
+			self->timelines[n++] = timeline;
+			continue;
+		}
+		if (removeSetupPose && _spTimeline_isSetupPose(timeline, skeletonData, *frames, *framesCount, tolerance))
+			spTimeline_dispose(timeline);
+		else
+			self->timelines[n++] = timeline;
+	}
+	if (n != self->timelinesCount) {
+		self->timelinesCount = n;
+		spAnimation_updateMasks(self, skeletonData);
+	}
+}
+
+/* Stores the keys of the timeline quantized and frees its frames, if the keys stay within the errors. Values are 16 bit or, if
+ * bytes is true, 8 bit steps across the range of each value in the timeline. */
+static void _spCurveTimeline_quantize (spCurveTimeline* self, float** frames, int framesCount, int entrySize, int/*bool*/bytes,
+		float timeError, float valueError) {
+	_spQuantizedKeys* keys;
+	const float* from = *frames;
+	int i, ii, keysCount = framesCount / entrySize, valuesCount = entrySize - 1;
+	float steps = bytes ? 255.0f : 65535.0f, key[5];
+	if (self->quantized || timeError < 0 || valueError < 0) return;
+
+	keys = NEW(_spQuantizedKeys);
+	keys->valuesCount = valuesCount;
+	keys->timeOffset = from[0];
+	keys->timeScale = (from[framesCount - entrySize] - from[0]) / 65535.0f;
+	keys->times = MALLOC(unsigned short, keysCount);
+	if (bytes)
+		keys->bytes = MALLOC(unsigned char, keysCount * valuesCount);
+	else
+		keys->values = MALLOC(unsigned short, keysCount * valuesCount);
+	for (ii = 0; ii < valuesCount; ++ii) {
+		float min = from[ii + 1], max = min;
+		for (i = 1; i < keysCount; ++i) {
+			float value = from[i * entrySize + ii + 1];
+			if (value < min) min = value;
+			if (value > max) max = value;
+		}
+		keys->offsets[ii] = min;
+		keys->scales[ii] = (max - min) / steps;
+	}
+
+	for (i = 0; i < keysCount; ++i) {
+		const float* frame = from + i * entrySize;
+		keys->times[i] = (unsigned short)(keys->timeScale ? (frame[0] - keys->timeOffset) / keys->timeScale + 0.5f : 0);
+		for (ii = 0; ii < valuesCount; ++ii) {
+			float step = keys->scales[ii] ? (frame[ii + 1] - keys->offsets[ii]) / keys->scales[ii] + 0.5f : 0;
+			if (bytes)
+				keys->bytes[i * valuesCount + ii] = (unsigned char)step;
+			else
+				keys->values[i * valuesCount + ii] = (unsigned short)step;
+		}
+
+		_spQuantizedKeys_decode(keys, i, key);
+		if (FABS(key[0] - frame[0]) > timeError) break;
+		for (ii = 0; ii < valuesCount; ++ii)
+			if (FABS(key[ii + 1] - frame[ii + 1]) > valueError) break;
+		if (ii < valuesCount) break;
+	}
+	if (i < keysCount) {
+		_spQuantizedKeys_dispose(keys);
+		return;
+	}
+
+	CONST_CAST(const void*, self->quantized) = keys;
+	FREE(*frames);
+	*frames = 0;
+}
+
+void spAnimation_dequantize (spAnimation* self) {
+	int i;
+	for (i = 0; i < self->timelinesCount; ++i)
+		_spTimeline_dequantize(self->timelines[i]);
+}
+
+void spAnimation_quantize (spAnimation* self, float timeError, float rotateError, float translateError, float scaleError,
+		float colorError) {
+	int i;
+	for (i = 0; i < self->timelinesCount; ++i) {
+		spTimeline* timeline = self->timelines[i];
+		switch (timeline->type) {
+		case SP_TIMELINE_ROTATE:
+		case SP_TIMELINE_TRANSLATE:
+		case SP_TIMELINE_SCALE: {
+			spBaseTimeline* baseTimeline = SUB_CAST(spBaseTimeline, timeline);
+			_spCurveTimeline_quantize(SUPER(baseTimeline), &CONST_CAST(float*, baseTimeline->frames), baseTimeline->framesCount,
+					timeline->type == SP_TIMELINE_ROTATE ? 2 : 3, 0, timeError,
+					timeline->type == SP_TIMELINE_ROTATE ? rotateError :
+							(timeline->type == SP_TIMELINE_TRANSLATE ? translateError : scaleError));
+			break;
+		}
+		case SP_TIMELINE_COLOR: {
+			spColorTimeline* colorTimeline = SUB_CAST(spColorTimeline, timeline);
+			_spCurveTimeline_quantize(SUPER(colorTimeline), &CONST_CAST(float*, colorTimeline->frames), colorTimeline->framesCount,
+					5, 1, timeError, colorError);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
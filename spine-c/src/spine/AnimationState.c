@@ -34,7 +34,14 @@
 #include <string.h>
 
 spTrackEntry* _spTrackEntry_create (spAnimationState* state) {
-	spTrackEntry* self = NEW(spTrackEntry);
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, state);
+	spTrackEntry* self = internal->trackEntryPool;
+	if (self) {
+		internal->trackEntryPool = self->next;
+		memset(self, 0, sizeof(spTrackEntry));
+	} else
+		self = SUPER(NEW(_spTrackEntry));
+	SUB_CAST(_spTrackEntry, self)->serial = ++internal->lastTrackEntrySerial;
 	CONST_CAST(spAnimationState*, self->state) = state;
 	self->timeScale = 1;
 	self->lastTime = -1;
@@ -43,8 +50,10 @@ spTrackEntry* _spTrackEntry_create (spAnimationState* state) {
 }
 
 void _spTrackEntry_dispose (spTrackEntry* self) {
-	if (self->previous) SUB_CAST(_spAnimationState, self->state)->disposeTrackEntry(self->previous);
-	FREE(self);
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self->state);
+	if (self->previous) internal->disposeTrackEntry(self->previous);
+	self->next = internal->trackEntryPool;
+	internal->trackEntryPool = self;
 }
 
 /**/
@@ -60,7 +69,6 @@ void _spAnimationState_disposeTrackEntry (spTrackEntry* entry) {
 spAnimationState* spAnimationState_create (spAnimationStateData* data) {
 	_spAnimationState* internal = NEW(_spAnimationState);
 	spAnimationState* self = SUPER(internal);
-	internal->events = MALLOC(spEvent*, 64);
 	self->timeScale = 1;
 	CONST_CAST(spAnimationStateData*, self->data) = data;
 	internal->createTrackEntry = _spAnimationState_createTrackEntry;
@@ -81,14 +89,37 @@ void spAnimationState_dispose (spAnimationState* self) {
 	int i;
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	FREE(internal->events);
+	FREE(internal->queue);
+	FREE(internal->skipMasks);
 	for (i = 0; i < self->tracksCount; ++i)
 		_spAnimationState_disposeAllEntries(self, self->tracks[i]);
 	FREE(self->tracks);
+	while (internal->trackEntryPool) {
+		spTrackEntry* next = internal->trackEntryPool->next;
+		FREE(SUB_CAST(_spTrackEntry, internal->trackEntryPool)->pairs);
+		FREE(internal->trackEntryPool);
+		internal->trackEntryPool = next;
+	}
 	FREE(self);
 }
 
 void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEntry* entry);
 
+/* Grows the events buffer to hold the most events the animation can fire in one apply: every frame of each event timeline,
+ * twice when a looping animation wraps. */
+static void _spAnimationState_ensureEventsCapacity (spAnimationState* self, const spAnimation* animation) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	int i, eventsCount = 0;
+	for (i = 0; i < animation->timelinesCount; ++i)
+		if (animation->timelines[i]->type == SP_TIMELINE_EVENT)
+			eventsCount += SUB_CAST(spEventTimeline, animation->timelines[i])->framesCount << 1;
+	if (eventsCount > internal->eventsCapacity) {
+		FREE(internal->events);
+		internal->events = MALLOC(spEvent*, eventsCount);
+		internal->eventsCapacity = eventsCount;
+	}
+}
+
 void spAnimationState_update (spAnimationState* self, float delta) {
 	int i;
 	float previousDelta;
@@ -114,6 +145,147 @@ void spAnimationState_update (spAnimationState* self, float delta) {
 	}
 }
 
+/* Queues a listener call, see deferEvents. */
+static void _spAnimationState_queue (spAnimationState* self, spTrackEntry* entry, int trackIndex, spEventType type,
+		spEvent* event, int loopCount) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	_spEventQueueEntry* queueEntry;
+	if (internal->queueCount == internal->queueCapacity) {
+		_spEventQueueEntry* newQueue;
+		internal->queueCapacity = internal->queueCapacity ? internal->queueCapacity << 1 : 16;
+		newQueue = MALLOC(_spEventQueueEntry, internal->queueCapacity);
+		if (internal->queueCount) memcpy(newQueue, internal->queue, internal->queueCount * sizeof(_spEventQueueEntry));
+		FREE(internal->queue);
+		internal->queue = newQueue;
+	}
+	queueEntry = internal->queue + internal->queueCount++;
+	queueEntry->entry = entry;
+	queueEntry->trackIndex = trackIndex;
+	queueEntry->type = type;
+	queueEntry->event = event;
+	queueEntry->loopCount = loopCount;
+}
+
+/* Returns true if the entry is no longer the current entry of the track. */
+static int _spAnimationState_changed (spAnimationState* self, int trackIndex, spTrackEntry* entry) {
+	return trackIndex >= self->tracksCount || self->tracks[trackIndex] != entry;
+}
+
+/* Drops the queued calls for entries that are no longer current. */
+static void _spAnimationState_dropChanged (spAnimationState* self, int start) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	int i;
+	for (i = start; i < internal->queueCount; ++i) {
+		_spEventQueueEntry* queueEntry = internal->queue + i;
+		if (queueEntry->entry && _spAnimationState_changed(self, queueEntry->trackIndex, queueEntry->entry)) queueEntry->entry = 0;
+	}
+}
+
+/* Calls the listeners for the queued calls. A listener may change any track, so afterward the remaining calls for entries
+ * that are no longer current are dropped, as when the listeners are called during apply. */
+static void _spAnimationState_dispatch (spAnimationState* self) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	int i;
+	for (i = 0; i < internal->queueCount; ++i) {
+		_spEventQueueEntry* queueEntry = internal->queue + i;
+		spTrackEntry* entry = queueEntry->entry;
+		if (!entry) continue;
+		if (entry->listener) {
+			entry->listener(self, queueEntry->trackIndex, queueEntry->type, queueEntry->event, queueEntry->loopCount);
+			_spAnimationState_dropChanged(self, i + 1);
+			if (_spAnimationState_changed(self, queueEntry->trackIndex, entry)) continue;
+		}
+		if (self->listener) {
+			self->listener(self, queueEntry->trackIndex, queueEntry->type, queueEntry->event, queueEntry->loopCount);
+			_spAnimationState_dropChanged(self, i + 1);
+		}
+	}
+	internal->queueCount = 0;
+}
+
+static void _spAnimationState_ensureSkipMasksCapacity (spAnimationState* self, int capacity) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	if (capacity > internal->skipMasksCapacity) {
+		FREE(internal->skipMasks);
+		internal->skipMasks = MALLOC(unsigned int, capacity);
+		internal->skipMasksCapacity = capacity;
+	}
+}
+
+/* Adds to mask the properties the entry replaces: those keyed from time 0 by an animation applied with full alpha, limited to the
+ * entry's bones mask. When mixing, the previous animation is applied with full alpha. */
+static void _spAnimationState_addReplaced (spTrackEntry* entry, const spSkeletonData* skeletonData, unsigned int* mask,
+		int wordsCount) {
+	const unsigned int* replaceMask;
+	int i, bit, boneBitsCount = skeletonData->bonesCount * 3;
+	if (entry->previous)
+		replaceMask = entry->previous->animation->replaceMask;
+	else if (entry->mix == 1 && entry->time >= 0)
+		replaceMask = entry->animation->replaceMask;
+	else
+		return;
+	if (!replaceMask) return;
+	for (i = 0; i < wordsCount; ++i) {
+		unsigned int bits = replaceMask[i];
+		if (!bits) continue;
+		if (entry->bonesMask) {
+			for (bit = 0; bit < 32 && (i << 5) + bit < boneBitsCount; ++bit) {
+				int boneIndex = ((i << 5) + bit) / 3;
+				if (!(entry->bonesMask[boneIndex >> 5] & (1u << (boneIndex & 31)))) bits &= ~(1u << bit);
+			}
+		}
+		mask[i] |= bits;
+	}
+}
+
+/* Computes for each track the properties that the tracks above it replace, so the track can skip applying them. Returns the
+ * number of words per track, or 0 when there is a single track without a bones mask and nothing can be skipped. */
+static int _spAnimationState_updateSkipMasks (spAnimationState* self, spSkeleton* skeleton) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	int i, wordsCount;
+	unsigned int* mask;
+	if (self->tracksCount == 0) return 0;
+	if (self->tracksCount == 1 && (!self->tracks[0] || !self->tracks[0]->bonesMask)) return 0;
+
+	wordsCount = _spAnimation_getMaskWordsCount(skeleton->data);
+	_spAnimationState_ensureSkipMasksCapacity(self, self->tracksCount * wordsCount);
+	mask = internal->skipMasks + (self->tracksCount - 1) * wordsCount;
+	memset(mask, 0, wordsCount * sizeof(unsigned int));
+	for (i = self->tracksCount - 2; i >= 0; --i, mask -= wordsCount) {
+		memcpy(mask - wordsCount, mask, wordsCount * sizeof(unsigned int));
+		if (self->tracks[i + 1]) _spAnimationState_addReplaced(self->tracks[i + 1], skeleton->data, mask - wordsCount, wordsCount);
+	}
+	return wordsCount;
+}
+
+/* Pairs the timelines of the entry's previous and current animations for _spAnimation_crossfade, unless they are already
+ * paired. */
+static void _spTrackEntry_pairTimelines (spTrackEntry* self, const spSkeletonData* skeletonData) {
+	_spTrackEntry* internal = SUB_CAST(_spTrackEntry, self);
+	const spAnimation* from = self->previous->animation;
+	const spAnimation* to = self->animation;
+	int count = from->timelinesCount + to->timelinesCount;
+	if (internal->pairsFrom == from && internal->pairsTo == to) return;
+	if (count > internal->pairsCapacity) {
+		FREE(internal->pairs);
+		internal->pairs = MALLOC(int, count);
+		internal->pairsCapacity = count;
+	}
+	internal->paired = _spAnimation_pairTimelines(from, to, skeletonData, internal->pairs);
+	internal->pairsFrom = from;
+	internal->pairsTo = to;
+}
+
+static void _spAnimationState_mix (const spAnimation* animation, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount, float alpha, const unsigned int* skipMask, const unsigned int* bonesMask) {
+	if (skipMask || bonesMask)
+		_spAnimation_mixMasked(animation, skeleton, lastTime, time, loop, events, eventsCount, alpha, skipMask, bonesMask);
+	else if (alpha == 1)
+		spAnimation_apply(animation, skeleton, lastTime, time, loop, events, eventsCount);
+	else
+		spAnimation_mix(animation, skeleton, lastTime, time, loop, events, eventsCount, alpha);
+}
+
 void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 
@@ -122,9 +294,16 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 	int entryChanged;
 	float time;
 	spTrackEntry* previous;
+	const unsigned int* skipMask = 0;
+	int wordsCount = _spAnimationState_updateSkipMasks(self, skeleton);
+	int maskedTracksCount = self->tracksCount;
 	for (i = 0; i < self->tracksCount; ++i) {
 		spTrackEntry* current = self->tracks[i];
 		if (!current) continue;
+		if (wordsCount) {
+			/* Tracks added by a listener during apply are not masked. */
+			skipMask = i < maskedTracksCount - 1 ? internal->skipMasks + i * wordsCount : 0;
+		}
 
 		eventsCount = 0;
 
@@ -132,28 +311,47 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 		if (!current->loop && time > current->endTime) time = current->endTime;
 
 		previous = current->previous;
-		if (!previous) {
-			if (current->mix == 1) {
-				spAnimation_apply(current->animation, skeleton, current->lastTime, time,
-					current->loop, internal->events, &eventsCount);
-			} else {
-				spAnimation_mix(current->animation, skeleton, current->lastTime, time,
-					current->loop, internal->events, &eventsCount, current->mix);
+		if (internal->eventsOnly) {
+			_spAnimation_fireEvents(current->animation, skeleton, current->lastTime, time, current->loop, internal->events,
+				&eventsCount);
+			if (previous && current->mixTime / current->mixDuration * current->mix >= 1) {
+				internal->disposeTrackEntry(current->previous);
+				current->previous = 0;
 			}
+		} else if (!previous) {
+			_spAnimationState_mix(current->animation, skeleton, current->lastTime, time,
+				current->loop, internal->events, &eventsCount, current->mix, skipMask, current->bonesMask);
 		} else {
 			float alpha = current->mixTime / current->mixDuration * current->mix;
 
 			float previousTime = previous->time;
 			if (!previous->loop && previousTime > previous->endTime) previousTime = previous->endTime;
-			spAnimation_apply(previous->animation, skeleton, previousTime, previousTime, previous->loop, 0, 0);
+			if (alpha > 1) alpha = 1;
+
+			_spTrackEntry_pairTimelines(current, skeleton->data);
+			if (!_spAnimation_crossfade(previous->animation, previousTime, previous->loop, current->animation, skeleton,
+				current->lastTime, time, current->loop, internal->events, &eventsCount, alpha, skipMask, current->bonesMask,
+				SUB_CAST(_spTrackEntry, current)->paired ? SUB_CAST(_spTrackEntry, current)->pairs : 0)) {
+				_spAnimationState_mix(previous->animation, skeleton, previousTime, previousTime, previous->loop, 0, 0, 1,
+					skipMask, current->bonesMask);
+				_spAnimationState_mix(current->animation, skeleton, current->lastTime, time,
+					current->loop, internal->events, &eventsCount, alpha, skipMask, current->bonesMask);
+			}
 
 			if (alpha >= 1) {
-				alpha = 1;
 				internal->disposeTrackEntry(current->previous);
 				current->previous = 0;
 			}
-			spAnimation_mix(current->animation, skeleton, current->lastTime, time,
-				current->loop, internal->events, &eventsCount, alpha);
+		}
+
+		if (self->deferEvents) {
+			for (ii = 0; ii < eventsCount; ++ii)
+				_spAnimationState_queue(self, current, i, SP_ANIMATION_EVENT, internal->events[ii], 0);
+			if (current->loop ? (FMOD(current->lastTime, current->endTime) > FMOD(time, current->endTime))
+					: (current->lastTime < current->endTime && time >= current->endTime))
+				_spAnimationState_queue(self, current, i, SP_ANIMATION_COMPLETE, 0, (int)(time / current->endTime));
+			current->lastTime = current->time;
+			continue;
 		}
 
 		entryChanged = 0;
@@ -192,6 +390,8 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 
 		current->lastTime = current->time;
 	}
+
+	if (internal->queueCount) _spAnimationState_dispatch(self);
 }
 
 void spAnimationState_clearTracks (spAnimationState* self) {
@@ -215,17 +415,60 @@ void spAnimationState_clearTrack (spAnimationState* self, int trackIndex) {
 	_spAnimationState_disposeAllEntries(self, current);
 }
 
-spTrackEntry* _spAnimationState_expandToIndex (spAnimationState* self, int index) {
-	spTrackEntry** newTracks;
-	if (index < self->tracksCount) return self->tracks[index];
-	newTracks = CALLOC(spTrackEntry*, index + 1);
-	memcpy(newTracks, self->tracks, self->tracksCount * sizeof(spTrackEntry*));
+static void _spAnimationState_growTracks (spAnimationState* self, int capacity) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	spTrackEntry** newTracks = CALLOC(spTrackEntry*, capacity);
+	if (self->tracksCount) memcpy(newTracks, self->tracks, self->tracksCount * sizeof(spTrackEntry*));
 	FREE(self->tracks);
 	self->tracks = newTracks;
+	internal->tracksCapacity = capacity;
+}
+
+spTrackEntry* _spAnimationState_expandToIndex (spAnimationState* self, int index) {
+	if (index < self->tracksCount) return self->tracks[index];
+	if (index >= SUB_CAST(_spAnimationState, self)->tracksCapacity)
+		_spAnimationState_growTracks(self, index + 1);
+	else
+		memset(self->tracks + self->tracksCount, 0, (index + 1 - self->tracksCount) * sizeof(spTrackEntry*));
 	self->tracksCount = index + 1;
 	return 0;
 }
 
+void spAnimationState_preallocate (spAnimationState* self, int tracksCount, int trackEntriesCount) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	int i;
+	if (tracksCount > internal->tracksCapacity) _spAnimationState_growTracks(self, tracksCount);
+	for (i = 0; i < trackEntriesCount; ++i) {
+		spTrackEntry* entry = SUPER(NEW(_spTrackEntry));
+		entry->next = internal->trackEntryPool;
+		internal->trackEntryPool = entry;
+	}
+	if (self->data) {
+		spSkeletonData* skeletonData = self->data->skeletonData;
+		int timelinesCount = 0;
+		spTrackEntry* entry;
+		for (i = 0; i < skeletonData->animationsCount; ++i) {
+			_spAnimationState_ensureEventsCapacity(self, skeletonData->animations[i]);
+			if (skeletonData->animations[i]->timelinesCount > timelinesCount)
+				timelinesCount = skeletonData->animations[i]->timelinesCount;
+		}
+		/* Room to pair the timelines of any two animations. */
+		for (entry = internal->trackEntryPool; entry; entry = entry->next) {
+			_spTrackEntry* entryInternal = SUB_CAST(_spTrackEntry, entry);
+			if (entryInternal->pairsCapacity >= timelinesCount * 2) continue;
+			FREE(entryInternal->pairs);
+			entryInternal->pairs = MALLOC(int, timelinesCount * 2);
+			entryInternal->pairsCapacity = timelinesCount * 2;
+		}
+		_spAnimationState_ensureSkipMasksCapacity(self, tracksCount * _spAnimation_getMaskWordsCount(skeletonData));
+	}
+	if (tracksCount * (internal->eventsCapacity + 1) > internal->queueCapacity) {
+		FREE(internal->queue);
+		internal->queueCapacity = tracksCount * (internal->eventsCapacity + 1);
+		internal->queue = MALLOC(_spEventQueueEntry, internal->queueCapacity);
+	}
+}
+
 void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEntry* entry) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 
@@ -250,6 +493,7 @@ void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEnt
 			internal->disposeTrackEntry(current);
 
 		if (previous) internal->disposeTrackEntry(previous);
+		if (entry->previous) _spTrackEntry_pairTimelines(entry, self->data->skeletonData);
 	}
 
 	self->tracks[index] = entry;
@@ -274,6 +518,7 @@ spTrackEntry* spAnimationState_setAnimation (spAnimationState* self, int trackIn
 	spTrackEntry* current = _spAnimationState_expandToIndex(self, trackIndex);
 	if (current) _spAnimationState_disposeAllEntries(self, current->next);
 
+	_spAnimationState_ensureEventsCapacity(self, animation);
 	entry = internal->createTrackEntry(self);
 	entry->animation = animation;
 	entry->loop = loop;
@@ -292,8 +537,10 @@ spTrackEntry* spAnimationState_addAnimation (spAnimationState* self, int trackIn
 		float delay) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	spTrackEntry* last;
+	spTrackEntry* entry;
 
-	spTrackEntry* entry = internal->createTrackEntry(self);
+	_spAnimationState_ensureEventsCapacity(self, animation);
+	entry = internal->createTrackEntry(self);
 	entry->animation = animation;
 	entry->loop = loop;
 	entry->endTime = animation->duration;
@@ -34,6 +34,13 @@
 
 static int yDown;
 
+typedef struct {
+	spBone super;
+	/* The sine and cosine of the world rotation they were last computed for, reused while it doesn't change. */
+	float cachedRotation;
+	float sine, cosine;
+} _spBone;
+
 void spBone_setYDown (int value) {
 	yDown = value;
 }
@@ -42,12 +49,16 @@ int spBone_isYDown () {
 	return yDown;
 }
 
-spBone* spBone_create (spBoneData* data, spSkeleton* skeleton, spBone* parent) {
-	spBone* self = NEW(spBone);
+void _spBone_init (spBone* self, spBoneData* data, spSkeleton* skeleton, spBone* parent) {
 	CONST_CAST(spBoneData*, self->data) = data;
 	CONST_CAST(spSkeleton*, self->skeleton) = skeleton;
 	CONST_CAST(spBone*, self->parent) = parent;
 	spBone_setToSetupPose(self);
+}
+
+spBone* spBone_create (spBoneData* data, spSkeleton* skeleton, spBone* parent) {
+	spBone* self = SUPER(NEW(_spBone));
+	_spBone_init(self, data, skeleton, parent);
 	return self;
 }
 
@@ -55,8 +66,34 @@ void spBone_dispose (spBone* self) {
 	FREE(self);
 }
 
+void _spBone_createBones (spBone** bones, int count) {
+	int i;
+	_spBone* block = CALLOC(_spBone, count);
+	for (i = 0; i < count; ++i)
+		bones[i] = &block[i].super;
+}
+
+void _spBone_disposeBones (spBone** bones, int count) {
+	if (count) FREE(SUB_CAST(_spBone, bones[0]));
+}
+
+void _spBone_getLocalPoses (spBone* const* bones, int count, _spBoneSetupPose* poses) {
+	const _spBone* bone = count ? SUB_CAST(_spBone, bones[0]) : 0;
+	const _spBoneSetupPose* end = poses + count;
+	for (; poses != end; ++poses, ++bone)
+		memcpy(poses, &bone->super.x, sizeof(_spBoneSetupPose));
+}
+
+void _spBone_setLocalPoses (spBone* const* bones, int count, const _spBoneSetupPose* poses) {
+	_spBone* bone = count ? SUB_CAST(_spBone, bones[0]) : 0;
+	const _spBoneSetupPose* end = poses + count;
+	for (; poses != end; ++poses, ++bone)
+		memcpy(&bone->super.x, poses, sizeof(_spBoneSetupPose));
+}
+
 void spBone_updateWorldTransform (spBone* self) {
-	float radians, cosine, sine;
+	_spBone* internal = SUB_CAST(_spBone, self);
+	float cosine, sine;
 	if (self->parent) {
 		CONST_CAST(float, self->worldX) = self->x * self->parent->m00 + self->y * self->parent->m01 + self->parent->worldX;
 		CONST_CAST(float, self->worldY) = self->x * self->parent->m10 + self->y * self->parent->m11 + self->parent->worldY;
@@ -81,9 +118,18 @@ void spBone_updateWorldTransform (spBone* self) {
 		CONST_CAST(int, self->worldFlipX) = skeletonFlipX ^ self->flipX;
 		CONST_CAST(int, self->worldFlipY) = skeletonFlipY ^ self->flipY;
 	}
-	radians = self->worldRotation * DEG_RAD;
-	cosine = COS(radians);
-	sine = SIN(radians);
+	if (self->worldRotation == 0) {
+		/* Common for unrotated bones. Keeps the sign of zero, as SIN would. */
+		cosine = 1;
+		sine = self->worldRotation;
+	} else {
+		if (self->worldRotation != internal->cachedRotation) {
+			internal->cachedRotation = self->worldRotation;
+			_spSinCos(self->worldRotation * DEG_RAD, &internal->sine, &internal->cosine);
+		}
+		cosine = internal->cosine;
+		sine = internal->sine;
+	}
 	if (self->worldFlipX) {
 		CONST_CAST(float, self->m00) = -cosine * self->worldScaleX;
 		CONST_CAST(float, self->m01) = sine * self->worldScaleY;
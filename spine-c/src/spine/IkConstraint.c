@@ -122,15 +122,124 @@ void spIkConstraint_apply2 (spBone* parent, spBone* child, float targetX, float
 	opposite = len2 * SIN(childAngle);
 	parentAngle = ATAN2(targetY * adjacent - targetX * opposite, targetX * adjacent + targetY * opposite);
 	rotation = (parentAngle - offset) * RAD_DEG - parentRotation;
-	if (rotation > 180)
-		rotation -= 360;
-	else if (rotation < -180) /**/
-		rotation += 360;
+	rotation -= 360 * ((rotation > 180) - (rotation < -180));
 	parent->rotationIK = parentRotation + rotation * alpha;
 	rotation = (childAngle + offset) * RAD_DEG - childRotation;
-	if (rotation > 180)
-		rotation -= 360;
-	else if (rotation < -180) /**/
-		rotation += 360;
+	rotation -= 360 * ((rotation > 180) - (rotation < -180));
 	child->rotationIK = childRotation + (rotation + parent->worldRotation - child->parent->worldRotation) * alpha;
 }
+
+/* The number of constraints spIkConstraint_applyBatch solves at a time. */
+#define BATCH_SIZE 32
+
+void spIkConstraint_applyBatch (spIkConstraint** constraints, int count) {
+	int i, ii, n1, n2;
+	float positionX, positionY, cosDenom, cosine, childAngle, adjacent, opposite, rotation;
+
+	/* One bone constraints: the target relative to the bone. */
+	spBone* bones[BATCH_SIZE];
+	float deltaX[BATCH_SIZE], deltaY[BATCH_SIZE], parentRotation1[BATCH_SIZE], alpha1[BATCH_SIZE];
+	int flip[BATCH_SIZE];
+
+	/* Two bone constraints: the target and child in the parent's space. */
+	spBone* parents[BATCH_SIZE];
+	spBone* children[BATCH_SIZE];
+	float targetX[BATCH_SIZE], targetY[BATCH_SIZE], childX[BATCH_SIZE], childY[BATCH_SIZE];
+	float offset[BATCH_SIZE], len1[BATCH_SIZE], len2[BATCH_SIZE], alpha2[BATCH_SIZE];
+	int bendDirection[BATCH_SIZE];
+
+	for (i = 0; i < count; i += BATCH_SIZE) {
+		int end = i + BATCH_SIZE < count ? i + BATCH_SIZE : count;
+
+		n1 = 0;
+		n2 = 0;
+		for (ii = i; ii < end; ++ii) {
+			spIkConstraint* constraint = constraints[ii];
+			float x = constraint->target->worldX, y = constraint->target->worldY;
+			if (constraint->bonesCount == 1) {
+				spBone* bone = constraint->bones[0];
+				bones[n1] = bone;
+				deltaX[n1] = x - bone->worldX;
+				deltaY[n1] = y - bone->worldY;
+				parentRotation1[n1] = (!bone->data->inheritRotation || !bone->parent) ? 0 : bone->parent->worldRotation;
+				flip[n1] = bone->worldFlipX != (bone->worldFlipY != spBone_isYDown());
+				alpha1[n1] = constraint->mix;
+				n1++;
+			} else if (constraint->bonesCount == 2) {
+				spBone* parent = constraint->bones[0];
+				spBone* child = constraint->bones[1];
+				spBone* parentParent = parent->parent;
+				if (constraint->mix == 0) {
+					child->rotationIK = child->rotation;
+					parent->rotationIK = parent->rotation;
+					continue;
+				}
+				parents[n2] = parent;
+				children[n2] = child;
+				if (parentParent) {
+					spBone_worldToLocal(parentParent, x, y, &positionX, &positionY);
+					targetX[n2] = (positionX - parent->x) * parentParent->worldScaleX;
+					targetY[n2] = (positionY - parent->y) * parentParent->worldScaleY;
+				} else {
+					targetX[n2] = x - parent->x;
+					targetY[n2] = y - parent->y;
+				}
+				if (child->parent == parent) {
+					positionX = child->x;
+					positionY = child->y;
+				} else {
+					spBone_localToWorld(child->parent, child->x, child->y, &positionX, &positionY);
+					spBone_worldToLocal(parent, positionX, positionY, &positionX, &positionY);
+				}
+				childX[n2] = positionX * parent->worldScaleX;
+				childY[n2] = positionY * parent->worldScaleY;
+				len2[n2] = child->data->length * child->worldScaleX;
+				bendDirection[n2] = constraint->bendDirection;
+				alpha2[n2] = constraint->mix;
+				n2++;
+			}
+		}
+
+		for (ii = 0; ii < n1; ++ii) {
+			spBone* bone = bones[ii];
+			rotation = ATAN2(deltaY[ii], deltaX[ii]) * RAD_DEG;
+			if (flip[ii]) rotation = -rotation;
+			rotation -= parentRotation1[ii];
+			bone->rotationIK = bone->rotation + (rotation - bone->rotation) * alpha1[ii];
+		}
+
+		for (ii = 0; ii < n2; ++ii) {
+			offset[ii] = ATAN2(childY[ii], childX[ii]);
+			len1[ii] = SQRT(childX[ii] * childX[ii] + childY[ii] * childY[ii]);
+		}
+
+		/* Same as spIkConstraint_apply2. */
+		for (ii = 0; ii < n2; ++ii) {
+			spBone* parent = parents[ii];
+			spBone* child = children[ii];
+			float parentRotation = parent->rotation, childRotation = child->rotation;
+			cosDenom = 2 * len1[ii] * len2[ii];
+			if (cosDenom < 0.0001f) {
+				child->rotationIK = childRotation
+						+ (ATAN2(targetY[ii], targetX[ii]) * RAD_DEG - parentRotation - childRotation) * alpha2[ii];
+				continue;
+			}
+			cosine = (targetX[ii] * targetX[ii] + targetY[ii] * targetY[ii] - len1[ii] * len1[ii] - len2[ii] * len2[ii])
+					/ cosDenom;
+			if (cosine < -1)
+				cosine = -1;
+			else if (cosine > 1) /**/
+				cosine = 1;
+			childAngle = ACOS(cosine) * bendDirection[ii];
+			adjacent = len1[ii] + len2[ii] * cosine;
+			opposite = len2[ii] * SIN(childAngle);
+			rotation = (ATAN2(targetY[ii] * adjacent - targetX[ii] * opposite, targetX[ii] * adjacent + targetY[ii] * opposite)
+					- offset[ii]) * RAD_DEG - parentRotation;
+			rotation -= 360 * ((rotation > 180) - (rotation < -180));
+			parent->rotationIK = parentRotation + rotation * alpha2[ii];
+			rotation = (childAngle + offset[ii]) * RAD_DEG - childRotation;
+			rotation -= 360 * ((rotation > 180) - (rotation < -180));
+			child->rotationIK = childRotation + (rotation + parent->worldRotation - child->parent->worldRotation) * alpha2[ii];
+		}
+	}
+}
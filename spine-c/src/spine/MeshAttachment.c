@@ -72,6 +72,16 @@ void spMeshAttachment_updateUVs (spMeshAttachment* self) {
 	}
 }
 
+void spMeshAttachment_updateBounds (spMeshAttachment* self) {
+	int i;
+	self->radius = 0;
+	for (i = 0; i < self->verticesCount; i += 2) {
+		float radius = self->vertices[i] * self->vertices[i] + self->vertices[i + 1] * self->vertices[i + 1];
+		if (radius > self->radius) self->radius = radius;
+	}
+	self->radius = SQRT(self->radius);
+}
+
 void spMeshAttachment_computeWorldVertices (spMeshAttachment* self, spSlot* slot, float* worldVertices) {
 	int i;
 	float* vertices = self->vertices;
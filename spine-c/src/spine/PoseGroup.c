@@ -0,0 +1,275 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/PoseGroup.h>
+#include <spine/extension.h>
+#include <string.h>
+
+/* Same layout as the fields of spBone from x to worldFlipY. */
+typedef struct {
+	float x, y;
+	float rotation, rotationIK;
+	float scaleX, scaleY;
+	int flipX, flipY;
+	float m00, m01, worldX;
+	float m10, m11, worldY;
+	float worldRotation;
+	float worldScaleX, worldScaleY;
+	int worldFlipX, worldFlipY;
+} _spBonePose;
+
+/* Zeroed before it is set, so keys can be compared and hashed as bytes. */
+typedef struct {
+	spAnimation* animation;
+	const unsigned int* bonesMask;
+	float time, lastTime, endTime;
+	float mix, mixTime, mixDuration;
+	int loop;
+	spAnimation* previousAnimation;
+	float previousTime, previousEndTime;
+	int previousLoop;
+} _spTrackKey;
+
+typedef struct {
+	spSkeleton* skeleton;
+	unsigned int hash;
+	int tracksCount;
+	int keysOffset; /* Index of the entry's first track key in the group's keys. */
+} _spPoseEntry;
+
+typedef struct {
+	spPoseGroup super;
+
+	_spPoseEntry* entries;
+	int entriesCount, entriesCapacity;
+
+	/* Open addressing with linear probing on the entry hash. Holds entry index + 1, 0 is empty. The size is a power of two
+	 * kept at least twice the entries count. */
+	int* table;
+	int tableSize;
+
+	_spTrackKey* keys;
+	int keysCount, keysCapacity;
+} _spPoseGroup;
+
+spPoseGroup* spPoseGroup_create () {
+	return SUPER(NEW(_spPoseGroup));
+}
+
+void spPoseGroup_dispose (spPoseGroup* self) {
+	_spPoseGroup* internal = SUB_CAST(_spPoseGroup, self);
+	FREE(internal->entries);
+	FREE(internal->table);
+	FREE(internal->keys);
+	FREE(self);
+}
+
+void spPoseGroup_clear (spPoseGroup* self) {
+	_spPoseGroup* internal = SUB_CAST(_spPoseGroup, self);
+	if (internal->entriesCount) memset(internal->table, 0, sizeof(int) * internal->tableSize);
+	internal->entriesCount = 0;
+	internal->keysCount = 0;
+	CONST_CAST(int, self->evaluatedCount) = 0;
+	CONST_CAST(int, self->sharedCount) = 0;
+}
+
+/* Appends the keys for the state's tracks, without trailing empty tracks, and returns the number of tracks. */
+static int _spPoseGroup_addKeys (_spPoseGroup* self, const spAnimationState* state) {
+	int i, tracksCount = state->tracksCount;
+	while (tracksCount > 0 && !state->tracks[tracksCount - 1])
+		tracksCount--;
+
+	if (self->keysCount + tracksCount > self->keysCapacity) {
+		int capacity = (self->keysCount + tracksCount) * 2;
+		_spTrackKey* keys = MALLOC(_spTrackKey, capacity);
+		memcpy(keys, self->keys, sizeof(_spTrackKey) * self->keysCount);
+		FREE(self->keys);
+		self->keys = keys;
+		self->keysCapacity = capacity;
+	}
+
+	for (i = 0; i < tracksCount; ++i) {
+		const spTrackEntry* entry = state->tracks[i];
+		_spTrackKey* key = self->keys + self->keysCount + i;
+		memset(key, 0, sizeof(_spTrackKey));
+		if (!entry) continue;
+		key->animation = entry->animation;
+		key->bonesMask = entry->bonesMask;
+		key->time = entry->time;
+		key->lastTime = entry->lastTime;
+		key->endTime = entry->endTime;
+		key->mix = entry->mix;
+		key->loop = entry->loop;
+		if (entry->previous) {
+			key->mixTime = entry->mixTime;
+			key->mixDuration = entry->mixDuration;
+			key->previousAnimation = entry->previous->animation;
+			key->previousTime = entry->previous->time;
+			key->previousEndTime = entry->previous->endTime;
+			key->previousLoop = entry->previous->loop;
+		}
+	}
+	return tracksCount;
+}
+
+static unsigned int _hash (const void* bytes, int size) {
+	const unsigned char* b = (const unsigned char*)bytes;
+	unsigned int hash = 2166136261u;
+	int i;
+	for (i = 0; i < size; ++i)
+		hash = (hash ^ b[i]) * 16777619u;
+	return hash;
+}
+
+/* Skeletons that update different bones have different world transforms, so they only share poses if the same bones are live. */
+static int/*bool*/_spSkeleton_liveBonesEqual (const spSkeleton* self, const spSkeleton* other) {
+	if (!self->liveBones || !other->liveBones) return self->liveBones == other->liveBones;
+	return !memcmp(self->liveBones, other->liveBones, sizeof(unsigned int) * ((self->bonesCount + 31) >> 5));
+}
+
+static _spPoseEntry* _spPoseGroup_findEntry (_spPoseGroup* self, const spSkeleton* skeleton, unsigned int hash,
+		int tracksCount) {
+	int i, mask = self->tableSize - 1;
+	if (!self->entriesCount) return 0;
+	for (i = hash & mask; self->table[i]; i = (i + 1) & mask) {
+		_spPoseEntry* entry = self->entries + self->table[i] - 1;
+		const spSkeleton* source = entry->skeleton;
+		if (entry->hash != hash || entry->tracksCount != tracksCount) continue;
+		if (source->data != skeleton->data || source->skin != skeleton->skin || source->flipX != skeleton->flipX
+				|| source->flipY != skeleton->flipY || !_spSkeleton_liveBonesEqual(source, skeleton)) continue;
+		if (memcmp(self->keys + entry->keysOffset, self->keys + self->keysCount, sizeof(_spTrackKey) * tracksCount))
+			continue;
+		return entry;
+	}
+	return 0;
+}
+
+static void _spPoseGroup_insert (_spPoseGroup* self, int entryIndex) {
+	int i, mask = self->tableSize - 1;
+	for (i = self->entries[entryIndex].hash & mask; self->table[i]; i = (i + 1) & mask)
+		;
+	self->table[i] = entryIndex + 1;
+}
+
+static void _spSkeleton_copyPose (spSkeleton* self, const spSkeleton* source) {
+	int i, ii;
+
+	for (i = 0; i < self->bonesCount; ++i)
+		memcpy(&self->bones[i]->x, &source->bones[i]->x, sizeof(_spBonePose));
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		const spSlot* sourceSlot = source->slots[i];
+		if (slot->attachment != sourceSlot->attachment) spSlot_setAttachment(slot, sourceSlot->attachment);
+		spSlot_setAttachmentTime(slot, spSlot_getAttachmentTime(sourceSlot));
+		slot->r = sourceSlot->r;
+		slot->g = sourceSlot->g;
+		slot->b = sourceSlot->b;
+		slot->a = sourceSlot->a;
+		if (sourceSlot->attachmentVerticesCount) {
+			int start, end;
+			_spSlot_getDeformedRange(sourceSlot, &start, &end);
+			_spSlot_setDeformedRange(slot, start, end);
+			if (slot->attachmentVerticesCapacity < sourceSlot->attachmentVerticesCount) {
+				FREE(slot->attachmentVertices);
+				slot->attachmentVertices = MALLOC(float, sourceSlot->attachmentVerticesCount);
+				slot->attachmentVerticesCapacity = sourceSlot->attachmentVerticesCount;
+			}
+			memcpy(slot->attachmentVertices, sourceSlot->attachmentVertices,
+					sizeof(float) * sourceSlot->attachmentVerticesCount);
+			slot->attachmentVerticesVersion++;
+		}
+		slot->attachmentVerticesCount = sourceSlot->attachmentVerticesCount;
+	}
+
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		self->ikConstraints[i]->bendDirection = source->ikConstraints[i]->bendDirection;
+		self->ikConstraints[i]->mix = source->ikConstraints[i]->mix;
+	}
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		ii = i;
+		/* The draw order is usually the setup pose order. */
+		if (source->drawOrder[i] != source->slots[i]) {
+			for (ii = 0; ii < self->slotsCount; ++ii)
+				if (source->drawOrder[i] == source->slots[ii]) break;
+		}
+		self->drawOrder[i] = self->slots[ii];
+	}
+}
+
+void spPoseGroup_apply (spPoseGroup* self, spAnimationState* state, spSkeleton* skeleton) {
+	_spPoseGroup* internal = SUB_CAST(_spPoseGroup, self);
+	_spAnimationState* internalState = SUB_CAST(_spAnimationState, state);
+	_spPoseEntry* entry;
+	unsigned int hash;
+	int tracksCount = _spPoseGroup_addKeys(internal, state);
+
+	hash = _hash(internal->keys + internal->keysCount, sizeof(_spTrackKey) * tracksCount);
+	entry = _spPoseGroup_findEntry(internal, skeleton, hash, tracksCount);
+	if (entry) {
+		_spSkeleton_copyPose(skeleton, entry->skeleton);
+		internalState->eventsOnly = 1;
+		spAnimationState_apply(state, skeleton);
+		internalState->eventsOnly = 0;
+		CONST_CAST(int, self->sharedCount)++;
+		return;
+	}
+
+	if (internal->entriesCount == internal->entriesCapacity) {
+		int capacity = internal->entriesCapacity ? internal->entriesCapacity * 2 : 8;
+		_spPoseEntry* entries = MALLOC(_spPoseEntry, capacity);
+		memcpy(entries, internal->entries, sizeof(_spPoseEntry) * internal->entriesCount);
+		FREE(internal->entries);
+		internal->entries = entries;
+		internal->entriesCapacity = capacity;
+	}
+	entry = internal->entries + internal->entriesCount++;
+	entry->skeleton = skeleton;
+	entry->hash = hash;
+	entry->tracksCount = tracksCount;
+	entry->keysOffset = internal->keysCount;
+	internal->keysCount += tracksCount;
+
+	if (internal->entriesCount * 2 > internal->tableSize) {
+		int i;
+		FREE(internal->table);
+		internal->tableSize = internal->tableSize ? internal->tableSize * 2 : 16;
+		internal->table = CALLOC(int, internal->tableSize);
+		for (i = 0; i < internal->entriesCount; ++i)
+			_spPoseGroup_insert(internal, i);
+	} else
+		_spPoseGroup_insert(internal, internal->entriesCount - 1);
+
+	spAnimationState_apply(state, skeleton);
+	spSkeleton_updateWorldTransform(skeleton);
+	CONST_CAST(int, self->evaluatedCount)++;
+}
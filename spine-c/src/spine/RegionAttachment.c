@@ -90,6 +90,7 @@ void spRegionAttachment_updateOffset (spRegionAttachment* self) {
 	float localX2Sin = localX2 * sine;
 	float localY2Cos = localY2 * cosine + self->y;
 	float localY2Sin = localY2 * sine;
+	int i;
 	self->offset[SP_VERTEX_X1] = localXCos - localYSin;
 	self->offset[SP_VERTEX_Y1] = localYCos + localXSin;
 	self->offset[SP_VERTEX_X2] = localXCos - localY2Sin;
@@ -98,6 +99,12 @@ void spRegionAttachment_updateOffset (spRegionAttachment* self) {
 	self->offset[SP_VERTEX_Y3] = localY2Cos + localX2Sin;
 	self->offset[SP_VERTEX_X4] = localX2Cos - localYSin;
 	self->offset[SP_VERTEX_Y4] = localYCos + localX2Sin;
+	self->radius = 0;
+	for (i = 0; i < 8; i += 2) {
+		float radius = self->offset[i] * self->offset[i] + self->offset[i + 1] * self->offset[i + 1];
+		if (radius > self->radius) self->radius = radius;
+	}
+	self->radius = SQRT(self->radius);
 }
 
 void spRegionAttachment_computeWorldVertices (spRegionAttachment* self, spBone* bone, float* vertices) {
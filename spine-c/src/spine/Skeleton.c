@@ -36,39 +36,35 @@
 typedef struct {
 	spSkeleton super;
 
-	int boneCacheCount;
-	int* boneCacheCounts;
-	spBone*** boneCache;
+	/* Set by spSkeleton_updateLiveBones, so the live bones can be recomputed when the skin changes. */
+	int/*bool*/liveBonesDrawn;
+	unsigned int* requiredBones;
+	int/*bool*/* liveIkConstraints;
+
+	/* Index of the skin in the data's skins, or -1 if there is no skin or the skin isn't one of the data's skins. */
+	int skinIndex;
 } _spSkeleton;
 
 spSkeleton* spSkeleton_create (spSkeletonData* data) {
 	int i, ii;
 
-	_spSkeleton* internal = NEW(_spSkeleton);
-	spSkeleton* self = SUPER(internal);
+	spSkeleton* self = SUPER(NEW(_spSkeleton));
 	CONST_CAST(spSkeletonData*, self->data) = data;
+	SUB_CAST(_spSkeleton, self)->skinIndex = -1;
+	if (!data->updateOrder) spSkeletonData_updateCache(data);
 
 	self->bonesCount = self->data->bonesCount;
 	self->bones = MALLOC(spBone*, self->bonesCount);
-
+	_spBone_createBones(self->bones, self->bonesCount);
 	for (i = 0; i < self->bonesCount; ++i) {
-		spBoneData* boneData = self->data->bones[i];
-		spBone* parent = 0;
-		if (boneData->parent) {
-			/* Find parent bone. */
-			for (ii = 0; ii < self->bonesCount; ++ii) {
-				if (data->bones[ii] == boneData->parent) {
-					parent = self->bones[ii];
-					break;
-				}
-			}
-		}
-		self->bones[i] = spBone_create(boneData, self, parent);
+		int parent = data->boneParents[i];
+		_spBone_init(self->bones[i], data->bones[i], self, parent == -1 ? 0 : self->bones[parent]);
 	}
 	CONST_CAST(spBone*, self->root) = self->bones[0];
 
 	self->slotsCount = data->slotsCount;
 	self->slots = MALLOC(spSlot*, self->slotsCount);
+	_spSlot_createSlots(self->slots, self->slotsCount);
 	for (i = 0; i < self->slotsCount; ++i) {
 		spSlotData *slotData = data->slots[i];
 
@@ -80,7 +76,7 @@ spSkeleton* spSkeleton_create (spSkeletonData* data) {
 				break;
 			}
 		}
-		self->slots[i] = spSlot_create(slotData, bone);
+		_spSlot_init(self->slots[i], slotData, bone, i);
 	}
 
 	self->drawOrder = MALLOC(spSlot*, self->slotsCount);
@@ -96,26 +92,16 @@ spSkeleton* spSkeleton_create (spSkeletonData* data) {
 	for (i = 0; i < self->data->ikConstraintsCount; ++i)
 		self->ikConstraints[i] = spIkConstraint_create(self->data->ikConstraints[i], self);
 
-	spSkeleton_updateCache(self);
-
 	return self;
 }
 
 void spSkeleton_dispose (spSkeleton* self) {
 	int i;
-	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
 
-	for (i = 0; i < internal->boneCacheCount; ++i)
-		FREE(internal->boneCache[i]);
-	FREE(internal->boneCache);
-	FREE(internal->boneCacheCounts);
-
-	for (i = 0; i < self->bonesCount; ++i)
-		spBone_dispose(self->bones[i]);
+	_spBone_disposeBones(self->bones, self->bonesCount);
 	FREE(self->bones);
 
-	for (i = 0; i < self->slotsCount; ++i)
-		spSlot_dispose(self->slots[i]);
+	_spSlot_disposeSlots(self->slots, self->slotsCount);
 	FREE(self->slots);
 
 	for (i = 0; i < self->ikConstraintsCount; ++i)
@@ -123,92 +109,143 @@ void spSkeleton_dispose (spSkeleton* self) {
 	FREE(self->ikConstraints);
 
 	FREE(self->drawOrder);
+	FREE(self->liveBones);
+	FREE(SUB_CAST(_spSkeleton, self)->requiredBones);
+	FREE(SUB_CAST(_spSkeleton, self)->liveIkConstraints);
 	FREE(self);
 }
 
 void spSkeleton_updateCache (const spSkeleton* self) {
-	int i, ii;
-	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	spSkeletonData_updateCache(self->data);
+}
 
-	for (i = 0; i < internal->boneCacheCount; ++i)
-		FREE(internal->boneCache[i]);
-	FREE(internal->boneCache);
-	FREE(internal->boneCacheCounts);
+void spSkeleton_updateWorldTransform (const spSkeleton* self) {
+	int i, n;
+	const int* updateOrder = self->data->updateOrder;
+	const unsigned int* liveBones = self->liveBones;
 
-	internal->boneCacheCount = self->ikConstraintsCount + 1;
-	internal->boneCache = MALLOC(spBone**, internal->boneCacheCount);
-	internal->boneCacheCounts = CALLOC(int, internal->boneCacheCount);
+	for (i = 0; i < self->bonesCount; ++i)
+		self->bones[i]->rotationIK = self->bones[i]->rotation;
 
-	/* Compute array sizes. */
-	for (i = 0; i < self->bonesCount; ++i) {
-		spBone* current = self->bones[i];
-		do {
-			for (ii = 0; ii < self->ikConstraintsCount; ++ii) {
-				spIkConstraint* ikConstraint = self->ikConstraints[ii];
-				spBone* parent = ikConstraint->bones[0];
-				spBone* child = ikConstraint->bones[ikConstraint->bonesCount - 1];
-				while (1) {
-					if (current == child) {
-						internal->boneCacheCounts[ii]++;
-						internal->boneCacheCounts[ii + 1]++;
-						goto outer1;
-					}
-					if (child == parent) break;
-					child = child->parent;
-				}
-			}
-			current = current->parent;
-		} while (current);
-		internal->boneCacheCounts[0]++;
-		outer1: {}
+	if (liveBones) {
+		const int* liveIkConstraints = SUB_CAST(_spSkeleton, self)->liveIkConstraints;
+		for (i = 0, n = self->data->updateOrderCount; i < n; ++i) {
+			int step = updateOrder[i];
+			if (step >= 0) {
+				if (liveBones[step >> 5] & (1u << (step & 31))) spBone_updateWorldTransform(self->bones[step]);
+			} else if (liveIkConstraints[~step])
+				spIkConstraint_apply(self->ikConstraints[~step]);
+		}
+		return;
 	}
 
-	for (i = 0; i < internal->boneCacheCount; ++i)
-		internal->boneCache[i] = MALLOC(spBone*, internal->boneCacheCounts[i]);
-	memset(internal->boneCacheCounts, 0, internal->boneCacheCount * sizeof(int));
+	for (i = 0, n = self->data->updateOrderCount; i < n; ++i) {
+		int step = updateOrder[i];
+		if (step >= 0)
+			spBone_updateWorldTransform(self->bones[step]);
+		else
+			spIkConstraint_apply(self->ikConstraints[~step]);
+	}
+}
 
-	/* Populate arrays. */
-	for (i = 0; i < self->bonesCount; ++i) {
-		spBone* bone = self->bones[i];
-		spBone* current = bone;
-		do {
-			for (ii = 0; ii < self->ikConstraintsCount; ++ii) {
-				spIkConstraint* ikConstraint = self->ikConstraints[ii];
-				spBone* parent = ikConstraint->bones[0];
-				spBone* child = ikConstraint->bones[ikConstraint->bonesCount - 1];
-				while (1) {
-					if (current == child) {
-						internal->boneCache[ii][internal->boneCacheCounts[ii]++] = bone;
-						internal->boneCache[ii + 1][internal->boneCacheCounts[ii + 1]++] = bone;
-						goto outer2;
-					}
-					if (child == parent) break;
-					child = child->parent;
-				}
-			}
-			current = current->parent;
-		} while (current);
-		internal->boneCache[0][internal->boneCacheCounts[0]++] = bone;
-		outer2: {}
+static int _spSkeleton_findBoneIndex (const spSkeleton* self, const spBone* bone) {
+	int i;
+	for (i = 0; i < self->bonesCount; ++i)
+		if (self->bones[i] == bone) return i;
+	return -1;
+}
+
+#define SET_BIT(BITS,INDEX) ((BITS)[(INDEX) >> 5] |= 1u << ((INDEX) & 31))
+#define GET_BIT(BITS,INDEX) ((BITS)[(INDEX) >> 5] & (1u << ((INDEX) & 31)))
+
+void _spSkeleton_addLiveBones (const spSkeleton* self, int slotIndex, const spAttachment* attachment, int/*bool*/drawn,
+		unsigned int* liveBones) {
+	switch (attachment->type) {
+	case SP_ATTACHMENT_BOUNDING_BOX:
+		break;
+	case SP_ATTACHMENT_REGION:
+	case SP_ATTACHMENT_MESH:
+		if (!drawn) return;
+		break;
+	case SP_ATTACHMENT_SKINNED_MESH: {
+		const spSkinnedMeshAttachment* mesh = SUB_CAST(spSkinnedMeshAttachment, attachment);
+		int v, nn;
+		if (!drawn) return;
+		for (v = 0; v < mesh->bonesCount;) {
+			nn = mesh->bones[v] + v;
+			for (v++; v <= nn; v++)
+				SET_BIT(liveBones, mesh->bones[v]);
+		}
+		break;
 	}
+	default:
+		return;
+	}
+	SET_BIT(liveBones, _spSkeleton_findBoneIndex(self, self->slots[slotIndex]->bone));
 }
 
-void spSkeleton_updateWorldTransform (const spSkeleton* self) {
-	int i, ii, nn, last;
+static void _spSkeleton_computeLiveBones (spSkeleton* self) {
 	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	unsigned int* liveBones = self->liveBones;
+	const int* boneParents = self->data->boneParents;
+	int i, ii, changed;
+
+	memcpy(liveBones, internal->requiredBones, ((self->bonesCount + 31) >> 5) * sizeof(unsigned int));
+	memset(internal->liveIkConstraints, 0, self->ikConstraintsCount * sizeof(int));
+	if (self->skin) _spSkin_addLiveBones(self->skin, self, internal->liveBonesDrawn, liveBones);
+	if (self->data->defaultSkin) _spSkin_addLiveBones(self->data->defaultSkin, self, internal->liveBonesDrawn, liveBones);
+	for (i = 0; i < self->slotsCount; ++i)
+		if (self->slots[i]->attachment)
+			_spSkeleton_addLiveBones(self, i, self->slots[i]->attachment, internal->liveBonesDrawn, liveBones);
+
+	do {
+		/* Parents come before their children, so one pass from the last bone reaches the root. */
+		for (i = self->bonesCount - 1; i > 0; --i)
+			if (GET_BIT(liveBones, i) && boneParents[i] != -1) SET_BIT(liveBones, boneParents[i]);
+
+		changed = 0;
+		for (i = 0; i < self->ikConstraintsCount; ++i) {
+			const spIkConstraint* ikConstraint = self->ikConstraints[i];
+			if (internal->liveIkConstraints[i]) continue;
+			for (ii = 0; ii < ikConstraint->bonesCount; ++ii)
+				if (GET_BIT(liveBones, _spSkeleton_findBoneIndex(self, ikConstraint->bones[ii]))) break;
+			if (ii == ikConstraint->bonesCount) continue;
+			internal->liveIkConstraints[i] = 1;
+			changed = 1;
+			SET_BIT(liveBones, _spSkeleton_findBoneIndex(self, ikConstraint->target));
+			for (ii = 0; ii < ikConstraint->bonesCount; ++ii)
+				SET_BIT(liveBones, _spSkeleton_findBoneIndex(self, ikConstraint->bones[ii]));
+		}
+	} while (changed);
+}
 
-	for (i = 0; i < self->bonesCount; ++i)
-		self->bones[i]->rotationIK = self->bones[i]->rotation;
-
-	i = 0;
-	last = internal->boneCacheCount - 1;
-	while (1) {
-		for (ii = 0, nn = internal->boneCacheCounts[i]; ii < nn; ++ii)
-			spBone_updateWorldTransform(internal->boneCache[i][ii]);
-		if (i == last) break;
-		spIkConstraint_apply(self->ikConstraints[i]);
-		i++;
+void spSkeleton_updateLiveBones (spSkeleton* self, int/*bool*/drawn, spBone** bones, int bonesCount) {
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	int i, wordsCount = (self->bonesCount + 31) >> 5;
+	if (!self->liveBones) {
+		CONST_CAST(unsigned int*, self->liveBones) = MALLOC(unsigned int, wordsCount);
+		internal->requiredBones = MALLOC(unsigned int, wordsCount);
+		internal->liveIkConstraints = MALLOC(int, self->ikConstraintsCount);
 	}
+	memset(internal->requiredBones, 0, wordsCount * sizeof(unsigned int));
+	for (i = 0; i < bonesCount; ++i)
+		SET_BIT(internal->requiredBones, _spSkeleton_findBoneIndex(self, bones[i]));
+	internal->liveBonesDrawn = drawn;
+	_spSkeleton_computeLiveBones(self);
+}
+
+const int* _spSkeleton_getLiveIkConstraints (const spSkeleton* self) {
+	return self->liveBones ? SUB_CAST(_spSkeleton, self)->liveIkConstraints : 0;
+}
+
+void spSkeleton_clearLiveBones (spSkeleton* self) {
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	FREE(self->liveBones);
+	FREE(internal->requiredBones);
+	FREE(internal->liveIkConstraints);
+	CONST_CAST(unsigned int*, self->liveBones) = 0;
+	internal->requiredBones = 0;
+	internal->liveIkConstraints = 0;
 }
 
 void spSkeleton_setToSetupPose (const spSkeleton* self) {
@@ -218,8 +255,7 @@ void spSkeleton_setToSetupPose (const spSkeleton* self) {
 
 void spSkeleton_setBonesToSetupPose (const spSkeleton* self) {
 	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		spBone_setToSetupPose(self->bones[i]);
+	_spBone_setLocalPoses(self->bones, self->bonesCount, self->data->setupBones);
 
 	for (i = 0; i < self->ikConstraintsCount; ++i) {
 		spIkConstraint* ikConstraint = self->ikConstraints[i];
@@ -228,11 +264,32 @@ void spSkeleton_setBonesToSetupPose (const spSkeleton* self) {
 	}
 }
 
+spAttachment** _spSkeleton_getSetupAttachments (const spSkeleton* self) {
+	const spSkeletonData* data = self->data;
+	int skinIndex = SUB_CAST(_spSkeleton, self)->skinIndex;
+	if (!self->skin) return data->setupAttachments + data->skinsCount * data->slotsCount;
+	if (skinIndex != -1 && skinIndex < data->skinsCount && data->skins[skinIndex] == self->skin)
+		return data->setupAttachments + skinIndex * data->slotsCount;
+	return 0;
+}
+
 void spSkeleton_setSlotsToSetupPose (const spSkeleton* self) {
 	int i;
+	spAttachment** setupAttachments = _spSkeleton_getSetupAttachments(self);
+
 	memcpy(self->drawOrder, self->slots, self->slotsCount * sizeof(spSlot*));
-	for (i = 0; i < self->slotsCount; ++i)
-		spSlot_setToSetupPose(self->slots[i]);
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		slot->r = slot->data->r;
+		slot->g = slot->data->g;
+		slot->b = slot->data->b;
+		slot->a = slot->data->a;
+		if (setupAttachments)
+			spSlot_setAttachment(slot, setupAttachments[i]);
+		else
+			spSlot_setAttachment(slot,
+					slot->data->attachmentName ? spSkeleton_getAttachmentForSlotIndex(self, i, slot->data->attachmentName) : 0);
+	}
 }
 
 spBone* spSkeleton_findBone (const spSkeleton* self, const char* boneName) {
@@ -292,6 +349,17 @@ void spSkeleton_setSkin (spSkeleton* self, spSkin* newSkin) {
 		}
 	}
 	CONST_CAST(spSkin*, self->skin) = newSkin;
+	SUB_CAST(_spSkeleton, self)->skinIndex = -1;
+	if (newSkin) {
+		int i;
+		for (i = 0; i < self->data->skinsCount; ++i) {
+			if (self->data->skins[i] == newSkin) {
+				SUB_CAST(_spSkeleton, self)->skinIndex = i;
+				break;
+			}
+		}
+	}
+	if (self->liveBones) _spSkeleton_computeLiveBones(self);
 }
 
 spAttachment* spSkeleton_getAttachmentForSlotName (const spSkeleton* self, const char* slotName, const char* attachmentName) {
@@ -340,3 +408,47 @@ spIkConstraint* spSkeleton_findIkConstraint (const spSkeleton* self, const char*
 void spSkeleton_update (spSkeleton* self, float deltaTime) {
 	self->time += deltaTime;
 }
+
+int/*bool*/spSkeleton_getBounds (const spSkeleton* self, float* bounds) {
+	float slotBounds[4];
+	int i, found = 0;
+	for (i = 0; i < self->slotsCount; ++i) {
+		if (!spSlot_getBounds(self->slots[i], slotBounds)) continue;
+		if (!found || slotBounds[0] < bounds[0]) bounds[0] = slotBounds[0];
+		if (!found || slotBounds[1] < bounds[1]) bounds[1] = slotBounds[1];
+		if (!found || slotBounds[2] > bounds[2]) bounds[2] = slotBounds[2];
+		if (!found || slotBounds[3] > bounds[3]) bounds[3] = slotBounds[3];
+		found = 1;
+	}
+	return found;
+}
+
+void spSkeleton_preallocate (spSkeleton* self) {
+	int i, ii, iii;
+	for (i = 0; i < self->data->animationsCount; ++i) {
+		spAnimation* animation = self->data->animations[i];
+		for (ii = 0; ii < animation->timelinesCount; ++ii) {
+			spFFDTimeline* timeline;
+			spSlot* slot;
+			if (animation->timelines[ii]->type != SP_TIMELINE_FFD) continue;
+			timeline = SUB_CAST(spFFDTimeline, animation->timelines[ii]);
+			slot = self->slots[timeline->slotIndex];
+			if (slot->attachmentVerticesCapacity < timeline->frameVerticesCount) {
+				float* vertices = MALLOC(float, timeline->frameVerticesCount);
+				if (slot->attachmentVerticesCount)
+					memcpy(vertices, slot->attachmentVertices, slot->attachmentVerticesCount * sizeof(float));
+				FREE(slot->attachmentVertices);
+				slot->attachmentVertices = vertices;
+				slot->attachmentVerticesCapacity = timeline->frameVerticesCount;
+			}
+		}
+	}
+	for (i = 0; i < self->data->skinsCount; ++i) {
+		spSkin* skin = self->data->skins[i];
+		for (ii = 0; ii < self->slotsCount; ++ii) {
+			const char* name;
+			for (iii = 0; (name = spSkin_getAttachmentName(skin, ii, iii)) != 0; ++iii)
+				_spSlot_reserveWorldVertices(self->slots[ii], spSkin_getAttachment(skin, ii, name));
+		}
+	}
+}
@@ -0,0 +1,314 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonBatch.h>
+#include <spine/extension.h>
+
+#define LANES 4
+
+/* One bone of LANES skeletons. */
+typedef struct {
+	float x[LANES], y[LANES];
+	float rotationIK[LANES];
+	float scaleX[LANES], scaleY[LANES];
+	int flipX[LANES], flipY[LANES];
+
+	float m00[LANES], m01[LANES], worldX[LANES];
+	float m10[LANES], m11[LANES], worldY[LANES];
+	float worldRotation[LANES];
+	float worldScaleX[LANES], worldScaleY[LANES];
+	int worldFlipX[LANES], worldFlipY[LANES];
+} _spBoneLanes;
+
+/* Same layout as the world transform fields of spBone, from m00 to worldFlipY. */
+typedef struct {
+	float m00, m01, worldX;
+	float m10, m11, worldY;
+	float worldRotation;
+	float worldScaleX, worldScaleY;
+	int worldFlipX, worldFlipY;
+} _spBoneWorld;
+
+typedef struct {
+	spSkeletonBatch super;
+
+	int** ikBones; /* For each IK constraint, the index of its target and then of its bones. */
+
+	int blocksCount;
+	_spBoneLanes* lanes; /* For each block of LANES skeletons, each bone. */
+	int* skeletonFlipX; /* For each lane of each block. */
+	int* skeletonFlipY;
+
+	spIkConstraint** ikConstraints; /* The constraints of every skeleton solved together, see spIkConstraint_applyBatch. */
+	int* ikSkeletons; /* The index of the skeleton of each of those constraints. */
+
+	/* A bit per bone, set for bones live in any of the skeletons. Only those bones are computed. See spSkeleton_updateLiveBones. */
+	unsigned int* liveBones;
+} _spSkeletonBatch;
+
+#define GET_BIT(BITS,INDEX) ((BITS)[(INDEX) >> 5] & (1u << ((INDEX) & 31)))
+
+static int _findBoneIndex (const spSkeleton* skeleton, const spBone* bone) {
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i)
+		if (skeleton->bones[i] == bone) return i;
+	return -1;
+}
+
+spSkeletonBatch* spSkeletonBatch_create (spSkeleton** skeletons, int skeletonsCount) {
+	int i, ii;
+	_spSkeletonBatch* internal = NEW(_spSkeletonBatch);
+	spSkeletonBatch* self = SUPER(internal);
+	const spSkeleton* skeleton = skeletons[0];
+
+	CONST_CAST(spSkeletonData*, self->data) = skeleton->data;
+	CONST_CAST(int, self->skeletonsCount) = skeletonsCount;
+	CONST_CAST(spSkeleton**, self->skeletons) = MALLOC(spSkeleton*, skeletonsCount);
+	memcpy(self->skeletons, skeletons, sizeof(spSkeleton*) * skeletonsCount);
+
+	internal->ikBones = MALLOC(int*, skeleton->ikConstraintsCount);
+	for (i = 0; i < skeleton->ikConstraintsCount; ++i) {
+		const spIkConstraint* ikConstraint = skeleton->ikConstraints[i];
+		internal->ikBones[i] = MALLOC(int, 1 + ikConstraint->bonesCount);
+		internal->ikBones[i][0] = _findBoneIndex(skeleton, ikConstraint->target);
+		for (ii = 0; ii < ikConstraint->bonesCount; ++ii)
+			internal->ikBones[i][1 + ii] = _findBoneIndex(skeleton, ikConstraint->bones[ii]);
+	}
+
+	internal->blocksCount = (skeletonsCount + LANES - 1) / LANES;
+	internal->lanes = MALLOC(_spBoneLanes, internal->blocksCount * skeleton->bonesCount);
+	internal->skeletonFlipX = MALLOC(int, internal->blocksCount * LANES);
+	internal->skeletonFlipY = MALLOC(int, internal->blocksCount * LANES);
+	internal->ikConstraints = MALLOC(spIkConstraint*, skeletonsCount);
+	internal->ikSkeletons = MALLOC(int, skeletonsCount);
+	internal->liveBones = MALLOC(unsigned int, (skeleton->bonesCount + 31) >> 5);
+	return self;
+}
+
+void spSkeletonBatch_dispose (spSkeletonBatch* self) {
+	int i;
+	_spSkeletonBatch* internal = SUB_CAST(_spSkeletonBatch, self);
+	for (i = 0; i < self->data->ikConstraintsCount; ++i)
+		FREE(internal->ikBones[i]);
+	FREE(internal->ikBones);
+	FREE(internal->lanes);
+	FREE(internal->skeletonFlipX);
+	FREE(internal->skeletonFlipY);
+	FREE(internal->ikConstraints);
+	FREE(internal->ikSkeletons);
+	FREE(internal->liveBones);
+	FREE(self->skeletons);
+	FREE(self);
+}
+
+/* Same as spBone_updateWorldTransform, for each lane. */
+static void _spBoneLanes_updateWorldTransform (_spBoneLanes* self, const _spBoneLanes* parent, const spBoneData* data,
+		const int* skeletonFlipX, const int* skeletonFlipY) {
+	int l, yDown = spBone_isYDown();
+	float cosine, sine;
+	if (parent) {
+		for (l = 0; l < LANES; ++l) {
+			self->worldX[l] = self->x[l] * parent->m00[l] + self->y[l] * parent->m01[l] + parent->worldX[l];
+			self->worldY[l] = self->x[l] * parent->m10[l] + self->y[l] * parent->m11[l] + parent->worldY[l];
+		}
+		if (data->inheritScale) {
+			for (l = 0; l < LANES; ++l) {
+				self->worldScaleX[l] = parent->worldScaleX[l] * self->scaleX[l];
+				self->worldScaleY[l] = parent->worldScaleY[l] * self->scaleY[l];
+			}
+		} else {
+			for (l = 0; l < LANES; ++l) {
+				self->worldScaleX[l] = self->scaleX[l];
+				self->worldScaleY[l] = self->scaleY[l];
+			}
+		}
+		if (data->inheritRotation) {
+			for (l = 0; l < LANES; ++l)
+				self->worldRotation[l] = parent->worldRotation[l] + self->rotationIK[l];
+		} else {
+			for (l = 0; l < LANES; ++l)
+				self->worldRotation[l] = self->rotationIK[l];
+		}
+		for (l = 0; l < LANES; ++l) {
+			self->worldFlipX[l] = parent->worldFlipX[l] ^ self->flipX[l];
+			self->worldFlipY[l] = parent->worldFlipY[l] ^ self->flipY[l];
+		}
+	} else {
+		for (l = 0; l < LANES; ++l) {
+			self->worldX[l] = skeletonFlipX[l] ? -self->x[l] : self->x[l];
+			self->worldY[l] = skeletonFlipY[l] != yDown ? -self->y[l] : self->y[l];
+			self->worldScaleX[l] = self->scaleX[l];
+			self->worldScaleY[l] = self->scaleY[l];
+			self->worldRotation[l] = self->rotationIK[l];
+			self->worldFlipX[l] = skeletonFlipX[l] ^ self->flipX[l];
+			self->worldFlipY[l] = skeletonFlipY[l] ^ self->flipY[l];
+		}
+	}
+	for (l = 0; l < LANES; ++l) {
+		_spSinCos(self->worldRotation[l] * DEG_RAD, &sine, &cosine);
+		self->m00[l] = (self->worldFlipX[l] ? -cosine : cosine) * self->worldScaleX[l];
+		self->m01[l] = (self->worldFlipX[l] ? sine : -sine) * self->worldScaleY[l];
+		self->m10[l] = (self->worldFlipY[l] != yDown ? -sine : sine) * self->worldScaleX[l];
+		self->m11[l] = (self->worldFlipY[l] != yDown ? -cosine : cosine) * self->worldScaleY[l];
+	}
+}
+
+static void _spBoneLanes_gather (_spBoneLanes* self, int lane, const spBone* bone) {
+	self->x[lane] = bone->x;
+	self->y[lane] = bone->y;
+	self->rotationIK[lane] = bone->rotation;
+	self->scaleX[lane] = bone->scaleX;
+	self->scaleY[lane] = bone->scaleY;
+	self->flipX[lane] = bone->flipX;
+	self->flipY[lane] = bone->flipY;
+}
+
+static void _spBoneLanes_scatter (const _spBoneLanes* self, int lane, spBone* bone) {
+	_spBoneWorld world;
+	world.m00 = self->m00[lane];
+	world.m01 = self->m01[lane];
+	world.worldX = self->worldX[lane];
+	world.m10 = self->m10[lane];
+	world.m11 = self->m11[lane];
+	world.worldY = self->worldY[lane];
+	world.worldRotation = self->worldRotation[lane];
+	world.worldScaleX = self->worldScaleX[lane];
+	world.worldScaleY = self->worldScaleY[lane];
+	world.worldFlipX = self->worldFlipX[lane];
+	world.worldFlipY = self->worldFlipY[lane];
+	memcpy((float*)&bone->m00, &world, sizeof(_spBoneWorld));
+	bone->rotationIK = self->rotationIK[lane];
+}
+
+/* The bones an IK constraint reads are stored to the skeletons it is live for, the constraint is solved for those skeletons at
+ * once and the rotations it computes are read back. */
+static void _spSkeletonBatch_applyIkConstraint (_spSkeletonBatch* self, int index) {
+	int s, i, n = 0;
+	spSkeletonBatch* batch = SUPER(self);
+	const int* bones = self->ikBones[index];
+	const int* boneParents = batch->data->boneParents;
+	int bonesCount = batch->skeletons[0]->ikConstraints[index]->bonesCount;
+	for (s = 0; s < batch->skeletonsCount; ++s) {
+		spSkeleton* skeleton = batch->skeletons[s];
+		const int* liveIkConstraints = _spSkeleton_getLiveIkConstraints(skeleton);
+		_spBoneLanes* lanes = self->lanes + (s / LANES) * batch->data->bonesCount;
+		int l = s % LANES;
+		if (liveIkConstraints && !liveIkConstraints[index]) continue;
+		_spBoneLanes_scatter(lanes + bones[0], l, skeleton->bones[bones[0]]);
+		for (i = 1; i <= bonesCount; ++i) {
+			_spBoneLanes_scatter(lanes + bones[i], l, skeleton->bones[bones[i]]);
+			if (boneParents[bones[i]] != -1)
+				_spBoneLanes_scatter(lanes + boneParents[bones[i]], l, skeleton->bones[boneParents[bones[i]]]);
+		}
+		self->ikConstraints[n] = skeleton->ikConstraints[index];
+		self->ikSkeletons[n++] = s;
+	}
+	if (!n) return;
+	spIkConstraint_applyBatch(self->ikConstraints, n);
+	for (i = 0; i < n; ++i) {
+		int ii;
+		s = self->ikSkeletons[i];
+		for (ii = 1; ii <= bonesCount; ++ii)
+			self->lanes[(s / LANES) * batch->data->bonesCount + bones[ii]].rotationIK[s % LANES] =
+					batch->skeletons[s]->bones[bones[ii]]->rotationIK;
+	}
+}
+
+/* Sets the batch's live bones to the union of the skeletons' live bones, or to all bones if any skeleton updates all bones. */
+static void _spSkeletonBatch_updateLiveBones (_spSkeletonBatch* self) {
+	spSkeletonBatch* batch = SUPER(self);
+	int i, s, wordsCount = (batch->data->bonesCount + 31) >> 5;
+	memset(self->liveBones, 0, wordsCount * sizeof(unsigned int));
+	for (s = 0; s < batch->skeletonsCount; ++s) {
+		const unsigned int* liveBones = batch->skeletons[s]->liveBones;
+		if (!liveBones) {
+			memset(self->liveBones, 0xff, wordsCount * sizeof(unsigned int));
+			return;
+		}
+		for (i = 0; i < wordsCount; ++i)
+			self->liveBones[i] |= liveBones[i];
+	}
+}
+
+/* Each step of the update order is done for every block before the next step, so IK steps are solved for all skeletons in one
+ * call. Bones live in none of the skeletons are skipped, and each skeleton only gets the world transforms of its own live
+ * bones, so pruned skeletons end up the same as with spSkeleton_updateWorldTransform. */
+void spSkeletonBatch_updateWorldTransform (spSkeletonBatch* self) {
+	_spSkeletonBatch* internal = SUB_CAST(_spSkeletonBatch, self);
+	int b, i, l, bonesCount = self->data->bonesCount;
+	const unsigned int* liveBones = internal->liveBones;
+
+	_spSkeletonBatch_updateLiveBones(internal);
+
+	for (b = 0; b < internal->blocksCount; ++b) {
+		_spBoneLanes* lanes = internal->lanes + b * bonesCount;
+		spSkeleton** skeletons = self->skeletons + b * LANES;
+		int skeletonsCount = self->skeletonsCount - b * LANES;
+		/* Unused lanes of the last block repeat the first skeleton. */
+		for (l = 0; l < LANES; ++l) {
+			const spSkeleton* skeleton = skeletons[l < skeletonsCount ? l : 0];
+			internal->skeletonFlipX[b * LANES + l] = skeleton->flipX;
+			internal->skeletonFlipY[b * LANES + l] = skeleton->flipY;
+			for (i = 0; i < bonesCount; ++i)
+				if (GET_BIT(liveBones, i)) _spBoneLanes_gather(lanes + i, l, skeleton->bones[i]);
+		}
+	}
+
+	for (i = 0; i < self->data->updateOrderCount; ++i) {
+		int step = self->data->updateOrder[i];
+		if (step >= 0) {
+			int parent = self->data->boneParents[step];
+			if (!GET_BIT(liveBones, step)) continue;
+			for (b = 0; b < internal->blocksCount; ++b) {
+				_spBoneLanes* lanes = internal->lanes + b * bonesCount;
+				_spBoneLanes_updateWorldTransform(lanes + step, parent == -1 ? 0 : lanes + parent, self->data->bones[step],
+						internal->skeletonFlipX + b * LANES, internal->skeletonFlipY + b * LANES);
+			}
+		} else
+			_spSkeletonBatch_applyIkConstraint(internal, ~step);
+	}
+
+	for (b = 0; b < internal->blocksCount; ++b) {
+		_spBoneLanes* lanes = internal->lanes + b * bonesCount;
+		spSkeleton** skeletons = self->skeletons + b * LANES;
+		int skeletonsCount = self->skeletonsCount - b * LANES;
+		if (skeletonsCount > LANES) skeletonsCount = LANES;
+		for (l = 0; l < skeletonsCount; ++l) {
+			spSkeleton* skeleton = skeletons[l];
+			for (i = 0; i < bonesCount; ++i) {
+				if (!skeleton->liveBones || GET_BIT(skeleton->liveBones, i))
+					_spBoneLanes_scatter(lanes + i, l, skeleton->bones[i]);
+				else
+					skeleton->bones[i]->rotationIK = skeleton->bones[i]->rotation;
+			}
+		}
+	}
+}
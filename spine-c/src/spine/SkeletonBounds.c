@@ -129,6 +129,7 @@ void spSkeletonBounds_update (spSkeletonBounds* self, spSkeleton* skeleton, int/
 	for (i = 0; i < skeleton->slotsCount; ++i) {
 		spPolygon* polygon;
 		spBoundingBoxAttachment* boundingBox;
+		const float* worldVertices;
 
 		spSlot* slot = skeleton->slots[i];
 		spAttachment* attachment = slot->attachment;
@@ -141,8 +142,8 @@ void spSkeletonBounds_update (spSkeletonBounds* self, spSkeleton* skeleton, int/
 			if (polygon) spPolygon_dispose(polygon);
 			self->polygons[self->count] = polygon = spPolygon_create(boundingBox->verticesCount);
 		}
-		polygon->count = boundingBox->verticesCount;
-		spBoundingBoxAttachment_computeWorldVertices(boundingBox, slot->bone, polygon->vertices);
+		worldVertices = spSlot_getWorldVertices(slot, &polygon->count);
+		memcpy(polygon->vertices, worldVertices, polygon->count * sizeof(float));
 
 		if (updateAabb) {
 			int ii = 0;
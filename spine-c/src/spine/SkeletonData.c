@@ -63,12 +63,279 @@ void spSkeletonData_dispose (spSkeletonData* self) {
 		spIkConstraintData_dispose(self->ikConstraints[i]);
 	FREE(self->ikConstraints);
 
+	FREE(self->boneParents);
+	FREE(self->updateOrder);
+	FREE(self->setupBones);
+	FREE(self->setupAttachments);
+
 	FREE(self->hash);
 	FREE(self->version);
 
 	FREE(self);
 }
 
+static int _spSkeletonData_findBoneIndex (const spSkeletonData* self, const spBoneData* bone) {
+	int i;
+	for (i = 0; i < self->bonesCount; ++i)
+		if (self->bones[i] == bone) return i;
+	return -1;
+}
+
+static spAttachment* _spSkeletonData_getSetupAttachment (const spSkeletonData* self, const spSkin* skin, int slotIndex) {
+	const char* attachmentName = self->slots[slotIndex]->attachmentName;
+	spAttachment* attachment = 0;
+	if (!attachmentName) return 0;
+	if (skin) attachment = spSkin_getAttachment(skin, slotIndex, attachmentName);
+	if (!attachment && self->defaultSkin) attachment = spSkin_getAttachment(self->defaultSkin, slotIndex, attachmentName);
+	return attachment;
+}
+
+static void _spSkeletonData_updateSetupPose (spSkeletonData* self) {
+	int i, ii;
+	_spBoneSetupPose* setupBones;
+
+	FREE(self->setupBones);
+	setupBones = MALLOC(_spBoneSetupPose, self->bonesCount);
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBoneData* data = self->bones[i];
+		setupBones[i].x = data->x;
+		setupBones[i].y = data->y;
+		setupBones[i].rotation = data->rotation;
+		setupBones[i].rotationIK = data->rotation;
+		setupBones[i].scaleX = data->scaleX;
+		setupBones[i].scaleY = data->scaleY;
+		setupBones[i].flipX = data->flipX;
+		setupBones[i].flipY = data->flipY;
+	}
+	self->setupBones = setupBones;
+
+	FREE(self->setupAttachments);
+	self->setupAttachments = MALLOC(spAttachment*, (self->skinsCount + 1) * self->slotsCount);
+	for (i = 0; i <= self->skinsCount; ++i) {
+		spSkin* skin = i < self->skinsCount ? self->skins[i] : 0;
+		spAttachment** attachments = self->setupAttachments + i * self->slotsCount;
+		for (ii = 0; ii < self->slotsCount; ++ii)
+			attachments[ii] = _spSkeletonData_getSetupAttachment(self, skin, ii);
+	}
+}
+
+void spSkeletonData_updateCache (spSkeletonData* self) {
+	int i, ii, level;
+	/* The first IK constraint each bone is in the chain of, or -1. */
+	int* ikConstraints = MALLOC(int, self->bonesCount);
+	/* The first IK constraint each bone or an ancestor is in the chain of, or -1. The bone is updated before that IK
+	 * constraint is applied and again after. Other bones are updated before the first IK constraint. */
+	int* levels = MALLOC(int, self->bonesCount);
+
+	FREE(self->boneParents);
+	self->boneParents = MALLOC(int, self->bonesCount);
+	for (i = 0; i < self->bonesCount; ++i) {
+		self->boneParents[i] = self->bones[i]->parent ? _spSkeletonData_findBoneIndex(self, self->bones[i]->parent) : -1;
+		ikConstraints[i] = -1;
+	}
+
+	for (i = self->ikConstraintsCount - 1; i >= 0; --i) {
+		spIkConstraintData* ikConstraint = self->ikConstraints[i];
+		int parent = _spSkeletonData_findBoneIndex(self, ikConstraint->bones[0]);
+		int child = _spSkeletonData_findBoneIndex(self, ikConstraint->bones[ikConstraint->bonesCount - 1]);
+		while (1) {
+			ikConstraints[child] = i;
+			if (child == parent || child == -1) break;
+			child = self->boneParents[child];
+		}
+	}
+
+	self->updateOrderCount = self->ikConstraintsCount;
+	for (i = 0; i < self->bonesCount; ++i) {
+		ii = i;
+		while (ii != -1 && ikConstraints[ii] == -1)
+			ii = self->boneParents[ii];
+		levels[i] = ii == -1 ? -1 : ikConstraints[ii];
+		self->updateOrderCount += levels[i] == -1 ? 1 : 2;
+	}
+
+	FREE(self->updateOrder);
+	self->updateOrder = MALLOC(int, self->updateOrderCount);
+	ii = 0;
+	for (level = 0; level <= self->ikConstraintsCount; ++level) {
+		for (i = 0; i < self->bonesCount; ++i)
+			if (levels[i] == level || levels[i] == level - 1 || (levels[i] == -1 && level == 0)) self->updateOrder[ii++] = i;
+		if (level < self->ikConstraintsCount) self->updateOrder[ii++] = ~level;
+	}
+
+	FREE(ikConstraints);
+	FREE(levels);
+
+	_spSkeletonData_updateSetupPose(self);
+}
+
+/* Returns the bone index of a bone timeline, or 0 for other timelines. */
+static int* _spTimeline_getBoneIndex (spTimeline* timeline) {
+	switch (timeline->type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE:
+		return &SUB_CAST(spBaseTimeline, timeline)->boneIndex;
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY:
+		return &SUB_CAST(spFlipTimeline, timeline)->boneIndex;
+	default:
+		return 0;
+	}
+}
+
+/* Sets the bones skinned meshes in any skin are weighted to in used, if not 0, and maps their bone indices and bounds bone
+ * indices through indices, if not 0. */
+static void _spSkeletonData_visitSkinnedMeshes (spSkeletonData* self, int* used, const int* indices) {
+	int i, ii, iii, v, nn;
+	const char* name;
+	for (i = 0; i < self->skinsCount; ++i) {
+		const spSkin* skin = self->skins[i];
+		for (ii = 0; ii < self->slotsCount; ++ii) {
+			for (iii = 0; (name = spSkin_getAttachmentName(skin, ii, iii)) != 0; ++iii) {
+				spAttachment* attachment = spSkin_getAttachment(skin, ii, name);
+				spSkinnedMeshAttachment* mesh;
+				if (attachment->type != SP_ATTACHMENT_SKINNED_MESH) continue;
+				mesh = SUB_CAST(spSkinnedMeshAttachment, attachment);
+				for (v = 0; v < mesh->bonesCount;) {
+					nn = mesh->bones[v] + v;
+					for (v++; v <= nn; v++) {
+						if (used) used[mesh->bones[v]] = 1;
+						if (indices) mesh->bones[v] = indices[mesh->bones[v]];
+					}
+				}
+				if (indices) {
+					for (v = 0; v < mesh->boundsBonesCount; ++v)
+						mesh->boundsBones[v] = indices[mesh->boundsBones[v]];
+				}
+			}
+		}
+	}
+}
+
+/* Moves the children of a bone to its parent, keeping their world transforms. */
+static void _spSkeletonData_foldBone (spSkeletonData* self, int boneIndex) {
+	spBoneData* bone = self->bones[boneIndex];
+	float cosine = COS(bone->rotation * DEG_RAD) * bone->scaleX, sine = SIN(bone->rotation * DEG_RAD) * bone->scaleX;
+	int i, ii, iii;
+	for (i = boneIndex + 1; i < self->bonesCount; ++i) {
+		spBoneData* child = self->bones[i];
+		float x = child->x, y = child->y;
+		if (child->parent != bone) continue;
+		child->x = bone->x + x * cosine - y * sine;
+		child->y = bone->y + x * sine + y * cosine;
+		if (child->inheritRotation) child->rotation += bone->rotation;
+		if (child->inheritScale) {
+			child->scaleX *= bone->scaleX;
+			child->scaleY *= bone->scaleX;
+		}
+		CONST_CAST(spBoneData*, child->parent) = bone->parent;
+
+		/* Translations are relative to the setup pose, so rotate and scale them the same way. */
+		for (ii = 0; ii < self->animationsCount; ++ii) {
+			spAnimation* animation = self->animations[ii];
+			for (iii = 0; iii < animation->timelinesCount; ++iii) {
+				spTranslateTimeline* timeline;
+				int frame;
+				if (animation->timelines[iii]->type != SP_TIMELINE_TRANSLATE) continue;
+				timeline = SUB_CAST(spTranslateTimeline, animation->timelines[iii]);
+				if (timeline->boneIndex != i) continue;
+				_spTimeline_dequantize(animation->timelines[iii]);
+				for (frame = 0; frame < timeline->framesCount; frame += 3) {
+					x = timeline->frames[frame + 1];
+					y = timeline->frames[frame + 2];
+					timeline->frames[frame + 1] = x * cosine - y * sine;
+					timeline->frames[frame + 2] = x * sine + y * cosine;
+				}
+			}
+		}
+	}
+}
+
+int spSkeletonData_foldStaticBones (spSkeletonData* self, const char** keptBoneNames, int keptBonesCount) {
+	int i, ii, n, foldedCount;
+	/* Bones something other than their children depend on. */
+	int* used = CALLOC(int, self->bonesCount);
+	/* Bones with a scale timeline, then bones whose world scale is always uniform. */
+	int* uniform = CALLOC(int, self->bonesCount);
+	int* indices = MALLOC(int, self->bonesCount);
+
+	for (i = 0; i < keptBonesCount; ++i) {
+		ii = spSkeletonData_findBoneIndex(self, keptBoneNames[i]);
+		if (ii != -1) used[ii] = 1;
+	}
+	for (i = 0; i < self->slotsCount; ++i)
+		used[_spSkeletonData_findBoneIndex(self, self->slots[i]->boneData)] = 1;
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		spIkConstraintData* ikConstraint = self->ikConstraints[i];
+		used[_spSkeletonData_findBoneIndex(self, ikConstraint->target)] = 1;
+		for (ii = 0; ii < ikConstraint->bonesCount; ++ii) {
+			spBoneData* bone = ikConstraint->bones[ii];
+			used[_spSkeletonData_findBoneIndex(self, bone)] = 1;
+			/* IK uses the bone's parent, so it can't change. */
+			if (bone->parent) used[_spSkeletonData_findBoneIndex(self, bone->parent)] = 1;
+		}
+	}
+	for (i = 0; i < self->animationsCount; ++i) {
+		spAnimation* animation = self->animations[i];
+		for (ii = 0; ii < animation->timelinesCount; ++ii) {
+			int* boneIndex = _spTimeline_getBoneIndex(animation->timelines[ii]);
+			if (!boneIndex) continue;
+			used[*boneIndex] = 1;
+			if (animation->timelines[ii]->type == SP_TIMELINE_SCALE) uniform[*boneIndex] = 1;
+		}
+	}
+	_spSkeletonData_visitSkinnedMeshes(self, used, 0);
+
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBoneData* bone = self->bones[i];
+		uniform[i] = !uniform[i] && bone->scaleX == bone->scaleY
+				&& (!bone->parent || !bone->inheritScale || uniform[_spSkeletonData_findBoneIndex(self, bone->parent)]);
+	}
+
+	/* A bone's children are folded into its parent only if that is exact: the bone must inherit rotation and scale, have a
+	 * uniform scale and no flips, and its parent's world scale must be uniform so the bone's rotation and scale commute with it.
+	 * Parents come first, so a chain of static bones is folded into its nearest remaining ancestor. */
+	for (i = 0, n = 0; i < self->bonesCount; ++i) {
+		spBoneData* bone = self->bones[i];
+		if (used[i] || !bone->parent || !bone->inheritScale || !bone->inheritRotation || bone->flipX || bone->flipY
+				|| bone->scaleX != bone->scaleY || !uniform[_spSkeletonData_findBoneIndex(self, bone->parent)]) {
+			indices[i] = n++;
+			continue;
+		}
+		_spSkeletonData_foldBone(self, i);
+		indices[i] = -1;
+	}
+	foldedCount = self->bonesCount - n;
+
+	if (foldedCount) {
+		for (i = 0; i < self->animationsCount; ++i) {
+			spAnimation* animation = self->animations[i];
+			for (ii = 0; ii < animation->timelinesCount; ++ii) {
+				int* boneIndex = _spTimeline_getBoneIndex(animation->timelines[ii]);
+				if (boneIndex) *boneIndex = indices[*boneIndex];
+			}
+		}
+		_spSkeletonData_visitSkinnedMeshes(self, 0, indices);
+		for (i = 0; i < self->bonesCount; ++i) {
+			if (indices[i] == -1)
+				spBoneData_dispose(self->bones[i]);
+			else
+				self->bones[indices[i]] = self->bones[i];
+		}
+		self->bonesCount = n;
+		/* The mask bits are laid out by bone index, and the slot and IK constraint bits follow the bones. */
+		for (i = 0; i < self->animationsCount; ++i)
+			spAnimation_updateMasks(self->animations[i], self);
+		spSkeletonData_updateCache(self);
+	}
+
+	FREE(used);
+	FREE(uniform);
+	FREE(indices);
+	return foldedCount;
+}
+
 spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName) {
 	int i;
 	for (i = 0; i < self->bonesCount; ++i)
@@ -124,3 +391,12 @@ spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self,
 		if (strcmp(self->ikConstraints[i]->name, ikConstraintName) == 0) return self->ikConstraints[i];
 	return 0;
 }
+
+int spSkeletonData_getMaxWorldVerticesCount (const spSkeletonData* self) {
+	int i, max = 0;
+	for (i = 0; i < self->skinsCount; ++i) {
+		int count = spSkin_getMaxWorldVerticesCount(self->skins[i]);
+		if (count > max) max = count;
+	}
+	return max;
+}
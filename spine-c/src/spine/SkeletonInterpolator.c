@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonInterpolator.h>
+#include <spine/extension.h>
+
+/* Same layout as the local transform fields of spBone, from x to flipY. */
+typedef struct {
+	float x, y;
+	float rotation, rotationIK;
+	float scaleX, scaleY;
+	int flipX, flipY;
+} _spBoneLocalPose;
+
+/* Same layout as the world transform fields of spBone, from m00 to worldFlipY. */
+typedef struct {
+	float m00, m01, worldX;
+	float m10, m11, worldY;
+	float worldRotation;
+	float worldScaleX, worldScaleY;
+	int worldFlipX, worldFlipY;
+} _spBoneWorldPose;
+
+typedef struct {
+	_spBoneLocalPose* locals;
+	_spBoneWorldPose* worlds;
+	float* colors; /* r, g, b, a for each slot. */
+} _spPose;
+
+typedef struct {
+	spSkeletonInterpolator super;
+	_spPose poses[2];
+	int current; /* Index of the most recent pose. */
+} _spSkeletonInterpolator;
+
+spSkeletonInterpolator* spSkeletonInterpolator_create (spSkeleton* skeleton) {
+	int i;
+	_spSkeletonInterpolator* internal = NEW(_spSkeletonInterpolator);
+	CONST_CAST(spSkeleton*, internal->super.skeleton) = skeleton;
+	for (i = 0; i < 2; ++i) {
+		internal->poses[i].locals = MALLOC(_spBoneLocalPose, skeleton->bonesCount);
+		internal->poses[i].worlds = MALLOC(_spBoneWorldPose, skeleton->bonesCount);
+		internal->poses[i].colors = MALLOC(float, skeleton->slotsCount << 2);
+	}
+	return SUPER(internal);
+}
+
+void spSkeletonInterpolator_dispose (spSkeletonInterpolator* self) {
+	int i;
+	_spSkeletonInterpolator* internal = SUB_CAST(_spSkeletonInterpolator, self);
+	for (i = 0; i < 2; ++i) {
+		FREE(internal->poses[i].locals);
+		FREE(internal->poses[i].worlds);
+		FREE(internal->poses[i].colors);
+	}
+	FREE(self);
+}
+
+static void _spPose_store (_spPose* self, const spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i) {
+		memcpy(self->locals + i, &skeleton->bones[i]->x, sizeof(_spBoneLocalPose));
+		memcpy(self->worlds + i, &skeleton->bones[i]->m00, sizeof(_spBoneWorldPose));
+	}
+	for (i = 0; i < skeleton->slotsCount; ++i)
+		memcpy(self->colors + (i << 2), &skeleton->slots[i]->r, sizeof(float) * 4);
+}
+
+static void _spPose_load (const _spPose* self, spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i) {
+		memcpy(&skeleton->bones[i]->x, self->locals + i, sizeof(_spBoneLocalPose));
+		memcpy((float*)&skeleton->bones[i]->m00, self->worlds + i, sizeof(_spBoneWorldPose));
+	}
+	for (i = 0; i < skeleton->slotsCount; ++i)
+		memcpy(&skeleton->slots[i]->r, self->colors + (i << 2), sizeof(float) * 4);
+}
+
+void spSkeletonInterpolator_capture (spSkeletonInterpolator* self) {
+	_spSkeletonInterpolator* internal = SUB_CAST(_spSkeletonInterpolator, self);
+	internal->current ^= 1;
+	_spPose_store(internal->poses + internal->current, self->skeleton);
+	if (self->posesCount < 2) CONST_CAST(int, self->posesCount) = self->posesCount + 1;
+}
+
+void spSkeletonInterpolator_reset (spSkeletonInterpolator* self) {
+	CONST_CAST(int, self->posesCount) = 0;
+}
+
+/* Returns the angle from a moved toward b by alpha, the short way around. */
+static float _interpolateRotation (float a, float b, float alpha) {
+	return a + _spWrapDegrees(b - a) * alpha;
+}
+
+void spSkeletonInterpolator_apply (spSkeletonInterpolator* self, float alpha) {
+	_spSkeletonInterpolator* internal = SUB_CAST(_spSkeletonInterpolator, self);
+	const _spPose* from = internal->poses + (internal->current ^ 1);
+	const _spPose* to = internal->poses + internal->current;
+	spSkeleton* skeleton = self->skeleton;
+	int i;
+
+	if (self->posesCount < 2 || alpha >= 1) {
+		if (self->posesCount) _spPose_load(to, skeleton);
+		return;
+	}
+	if (alpha < 0) alpha = 0;
+
+	/* Bones are interpolated in local space and the world transforms computed from them, so bones move along arcs around
+	 * their parents rather than cutting across. IK is not solved again, the interpolated IK rotations are used. Bones are
+	 * ordered parents first. */
+	for (i = 0; i < skeleton->bonesCount; ++i) {
+		const _spBoneLocalPose* a = from->locals + i;
+		const _spBoneLocalPose* b = to->locals + i;
+		spBone* bone = skeleton->bones[i];
+		bone->x = a->x + (b->x - a->x) * alpha;
+		bone->y = a->y + (b->y - a->y) * alpha;
+		bone->rotation = _interpolateRotation(a->rotation, b->rotation, alpha);
+		bone->rotationIK = _interpolateRotation(a->rotationIK, b->rotationIK, alpha);
+		bone->scaleX = a->scaleX + (b->scaleX - a->scaleX) * alpha;
+		bone->scaleY = a->scaleY + (b->scaleY - a->scaleY) * alpha;
+		bone->flipX = b->flipX;
+		bone->flipY = b->flipY;
+		spBone_updateWorldTransform(bone);
+	}
+
+	for (i = 0; i < skeleton->slotsCount; ++i) {
+		const float* a = from->colors + (i << 2);
+		const float* b = to->colors + (i << 2);
+		spSlot* slot = skeleton->slots[i];
+		slot->r = a[0] + (b[0] - a[0]) * alpha;
+		slot->g = a[1] + (b[1] - a[1]) * alpha;
+		slot->b = a[2] + (b[2] - a[2]) * alpha;
+		slot->a = a[3] + (b[3] - a[3]) * alpha;
+	}
+}
+
+void spSkeletonInterpolator_restore (spSkeletonInterpolator* self) {
+	_spSkeletonInterpolator* internal = SUB_CAST(_spSkeletonInterpolator, self);
+	if (self->posesCount) _spPose_load(internal->poses + internal->current, self->skeleton);
+}
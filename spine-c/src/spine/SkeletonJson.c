@@ -290,34 +290,14 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 				tempVertices = MALLOC(float, verticesCount);
 				for (frame = timelineArray->child, i = 0; frame; frame = frame->next, ++i) {
 					Json* vertices = Json_getItem(frame, "vertices");
-					float* frameVertices;
-					if (!vertices) {
-						if (attachment->type == SP_ATTACHMENT_MESH)
-							frameVertices = SUB_CAST(spMeshAttachment, attachment)->vertices;
-						else {
-							frameVertices = tempVertices;
-							memset(frameVertices, 0, sizeof(float) * verticesCount);
-						}
-					} else {
-						int v, start = Json_getInt(frame, "offset", 0);
+					int v = 0, start = 0;
+					if (vertices) {
 						Json* vertex;
-						frameVertices = tempVertices;
-						memset(frameVertices, 0, sizeof(float) * start);
-						if (self->scale == 1) {
-							for (vertex = vertices->child, v = start; vertex; vertex = vertex->next, ++v)
-								frameVertices[v] = vertex->valueFloat;
-						} else {
-							for (vertex = vertices->child, v = start; vertex; vertex = vertex->next, ++v)
-								frameVertices[v] = vertex->valueFloat * self->scale;
-						}
-						memset(frameVertices + v, 0, sizeof(float) * (verticesCount - v));
-						if (attachment->type == SP_ATTACHMENT_MESH) {
-							float* meshVertices = SUB_CAST(spMeshAttachment, attachment)->vertices;
-							for (v = 0; v < verticesCount; ++v)
-								frameVertices[v] += meshVertices[v];
-						}
+						start = Json_getInt(frame, "offset", 0);
+						for (vertex = vertices->child; vertex && start + v < verticesCount; vertex = vertex->next, ++v)
+							tempVertices[v] = vertex->valueFloat * self->scale;
 					}
-					spFFDTimeline_setFrame(timeline, i, Json_getFloat(frame, "time", 0), frameVertices);
+					spFFDTimeline_setSparseFrame(timeline, i, Json_getFloat(frame, "time", 0), start, v, tempVertices);
 					readCurve(SUPER(timeline), i, frame);
 				}
 				FREE(tempVertices);
@@ -401,6 +381,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		if (duration > animation->duration) animation->duration = duration;
 	}
 
+	spAnimation_updateMasks(animation, skeletonData);
+	if (self->reduceKeys) spAnimation_reduceKeys(animation, skeletonData, self->keyTolerance, self->removeSetupPoseTimelines);
 	return animation;
 }
 
@@ -655,6 +637,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 							mesh->regionUVs[i] = entry->valueFloat;
 
 						spMeshAttachment_updateUVs(mesh);
+						spMeshAttachment_updateBounds(mesh);
 
 						color = Json_getString(attachmentMap, "color", 0);
 						if (color) {
@@ -726,6 +709,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 							mesh->triangles[i] = entry->valueInt;
 
 						spSkinnedMeshAttachment_updateUVs(mesh);
+						spSkinnedMeshAttachment_updateBounds(mesh);
 
 						color = Json_getString(attachmentMap, "color", 0);
 						if (color) {
@@ -792,6 +776,14 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			_spSkeletonJson_readAnimation(self, animationMap, skeletonData);
 	}
 
+	spSkeletonData_updateCache(skeletonData);
+	if (self->foldStaticBones) spSkeletonData_foldStaticBones(skeletonData, self->keptBoneNames, self->keptBonesCount);
+	if (self->quantize) {
+		for (i = 0; i < skeletonData->animationsCount; ++i)
+			spAnimation_quantize(skeletonData->animations[i], self->quantizeTimeError, self->quantizeRotateError,
+					self->quantizeTranslateError, self->quantizeScaleError, self->quantizeColorError);
+	}
+
 	Json_dispose(root);
 	return skeletonData;
 }
@@ -0,0 +1,268 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonPose.h>
+#include <spine/extension.h>
+
+/* Incremented when the buffer layout changes. */
+static const int POSE_VERSION = 2;
+
+/* The element structs have the same layout as the fields they are copied from. */
+typedef struct {
+	float r, g, b, a;
+	float time;
+	int flipX, flipY;
+	float x, y;
+} _spSkeletonFieldsPose;
+
+typedef struct {
+	int version;
+	int bonesCount, slotsCount, ikConstraintsCount;
+	_spSkeletonFieldsPose skeleton;
+} _spSkeletonPoseHeader;
+
+typedef struct {
+	spAttachment* attachment;
+	float attachmentTime;
+	float r, g, b, a;
+} _spSlotPose;
+
+typedef struct {
+	int bendDirection;
+	float mix;
+} _spIkConstraintPose;
+
+static int _align (int size) {
+	return (size + (int)sizeof(void*) - 1) & ~((int)sizeof(void*) - 1);
+}
+
+/* The buffer is the header followed by the bones, slots, IK constraints and draw order slot indices. */
+static int _bonesOffset () {
+	return _align(sizeof(_spSkeletonPoseHeader));
+}
+
+static int _slotsOffset (int bonesCount) {
+	return _bonesOffset() + _align(bonesCount * sizeof(_spBoneSetupPose));
+}
+
+static int _ikConstraintsOffset (int bonesCount, int slotsCount) {
+	return _slotsOffset(bonesCount) + _align(slotsCount * sizeof(_spSlotPose));
+}
+
+static int _drawOrderOffset (int bonesCount, int slotsCount, int ikConstraintsCount) {
+	return _ikConstraintsOffset(bonesCount, slotsCount) + _align(ikConstraintsCount * sizeof(_spIkConstraintPose));
+}
+
+spSkeletonPose* spSkeletonPose_create (spSkeletonData* data) {
+	spSkeletonPose* self = NEW(spSkeletonPose);
+	CONST_CAST(spSkeletonData*, self->data) = data;
+	CONST_CAST(int, self->size) = _drawOrderOffset(data->bonesCount, data->slotsCount, data->ikConstraintsCount)
+			+ data->slotsCount * sizeof(int);
+	CONST_CAST(void*, self->buffer) = CALLOC(char, self->size);
+	return self;
+}
+
+void spSkeletonPose_dispose (spSkeletonPose* self) {
+	FREE(self->buffer);
+	FREE(self);
+}
+
+void spSkeleton_capturePose (const spSkeleton* self, spSkeletonPose* pose) {
+	int i;
+	char* buffer = (char*)pose->buffer;
+	_spSkeletonPoseHeader* header = (_spSkeletonPoseHeader*)buffer;
+	_spBoneSetupPose* bones = (_spBoneSetupPose*)(buffer + _bonesOffset());
+	_spSlotPose* slots = (_spSlotPose*)(buffer + _slotsOffset(self->bonesCount));
+	_spIkConstraintPose* ikConstraints = (_spIkConstraintPose*)(buffer
+			+ _ikConstraintsOffset(self->bonesCount, self->slotsCount));
+	int* drawOrder = (int*)(buffer + _drawOrderOffset(self->bonesCount, self->slotsCount, self->ikConstraintsCount));
+
+	header->version = POSE_VERSION;
+	header->bonesCount = self->bonesCount;
+	header->slotsCount = self->slotsCount;
+	header->ikConstraintsCount = self->ikConstraintsCount;
+	memcpy(&header->skeleton, &self->r, sizeof(_spSkeletonFieldsPose));
+
+	_spBone_getLocalPoses(self->bones, self->bonesCount, bones);
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		const spSlot* slot = self->slots[i];
+		slots[i].attachment = slot->attachment;
+		slots[i].attachmentTime = spSlot_getAttachmentTime(slot);
+		memcpy(&slots[i].r, &slot->r, sizeof(float) * 4);
+	}
+
+	for (i = 0; i < self->ikConstraintsCount; ++i)
+		memcpy(ikConstraints + i, &self->ikConstraints[i]->bendDirection, sizeof(_spIkConstraintPose));
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		int ii = i;
+		/* The draw order is usually the setup pose order. */
+		if (self->drawOrder[i] != self->slots[i]) {
+			for (ii = 0; ii < self->slotsCount; ++ii)
+				if (self->drawOrder[i] == self->slots[ii]) break;
+		}
+		drawOrder[i] = ii;
+	}
+}
+
+int/*bool*/spSkeleton_restorePose (spSkeleton* self, const spSkeletonPose* pose) {
+	int i;
+	const char* buffer = (const char*)pose->buffer;
+	const _spSkeletonPoseHeader* header = (const _spSkeletonPoseHeader*)buffer;
+	const _spBoneSetupPose* bones;
+	const _spSlotPose* slots;
+	const _spIkConstraintPose* ikConstraints;
+	const int* drawOrder;
+
+	if (header->version != POSE_VERSION || header->bonesCount != self->bonesCount || header->slotsCount != self->slotsCount
+			|| header->ikConstraintsCount != self->ikConstraintsCount) return 0;
+
+	bones = (const _spBoneSetupPose*)(buffer + _bonesOffset());
+	slots = (const _spSlotPose*)(buffer + _slotsOffset(self->bonesCount));
+	ikConstraints = (const _spIkConstraintPose*)(buffer + _ikConstraintsOffset(self->bonesCount, self->slotsCount));
+	drawOrder = (const int*)(buffer + _drawOrderOffset(self->bonesCount, self->slotsCount, self->ikConstraintsCount));
+
+	/* The bones are walked as one block, but their pose fields are not one range: each bone's data, skeleton and parent
+	 * pointers sit between them. Slot attachments go through spSlot_setAttachment, only when they differ, so the FFD vertices
+	 * are reset when the attachment changes. */
+	memcpy(&self->r, &header->skeleton, sizeof(_spSkeletonFieldsPose));
+
+	_spBone_setLocalPoses(self->bones, self->bonesCount, bones);
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		if (slot->attachment != slots[i].attachment) spSlot_setAttachment(slot, slots[i].attachment);
+		spSlot_setAttachmentTime(slot, slots[i].attachmentTime);
+		memcpy(&slot->r, &slots[i].r, sizeof(float) * 4);
+	}
+
+	for (i = 0; i < self->ikConstraintsCount; ++i)
+		memcpy(&self->ikConstraints[i]->bendDirection, ikConstraints + i, sizeof(_spIkConstraintPose));
+
+	for (i = 0; i < self->slotsCount; ++i)
+		self->drawOrder[i] = self->slots[drawOrder[i]];
+	return 1;
+}
+
+/**/
+
+typedef struct {
+	int version;
+	int tracksCount;
+} _spAnimationStatePoseHeader;
+
+/* Entries are pooled, so they are identified by serial rather than by pointer. A serial of 0 means no entry. */
+typedef struct {
+	unsigned int entrySerial;
+	spAnimation* animation;
+	unsigned int previousSerial;
+	float time, lastTime, mixTime;
+	float previousTime;
+} _spTrackPose;
+
+static unsigned int _spTrackEntry_getSerial (const spTrackEntry* entry) {
+	return entry ? SUB_CAST(_spTrackEntry, entry)->serial : 0;
+}
+
+static int _tracksOffset () {
+	return _align(sizeof(_spAnimationStatePoseHeader));
+}
+
+spAnimationStatePose* spAnimationStatePose_create (int tracksCount) {
+	spAnimationStatePose* self = NEW(spAnimationStatePose);
+	CONST_CAST(int, self->size) = _tracksOffset() + tracksCount * sizeof(_spTrackPose);
+	CONST_CAST(void*, self->buffer) = CALLOC(char, self->size);
+	return self;
+}
+
+void spAnimationStatePose_dispose (spAnimationStatePose* self) {
+	FREE(self->buffer);
+	FREE(self);
+}
+
+void spAnimationState_capturePose (const spAnimationState* self, spAnimationStatePose* pose) {
+	int i;
+	_spAnimationStatePoseHeader* header;
+	_spTrackPose* tracks;
+	int size = _tracksOffset() + self->tracksCount * sizeof(_spTrackPose);
+	if (size > pose->size) {
+		FREE(pose->buffer);
+		CONST_CAST(int, pose->size) = size;
+		CONST_CAST(void*, pose->buffer) = CALLOC(char, size);
+	}
+	header = (_spAnimationStatePoseHeader*)pose->buffer;
+	tracks = (_spTrackPose*)((char*)pose->buffer + _tracksOffset());
+
+	header->version = POSE_VERSION;
+	header->tracksCount = self->tracksCount;
+	for (i = 0; i < self->tracksCount; ++i) {
+		spTrackEntry* entry = self->tracks[i];
+		_spTrackPose* track = tracks + i;
+		track->entrySerial = _spTrackEntry_getSerial(entry);
+		if (!entry) continue;
+		track->animation = entry->animation;
+		track->previousSerial = _spTrackEntry_getSerial(entry->previous);
+		track->time = entry->time;
+		track->lastTime = entry->lastTime;
+		track->mixTime = entry->mixTime;
+		track->previousTime = entry->previous ? entry->previous->time : 0;
+	}
+}
+
+int/*bool*/spAnimationState_restorePose (spAnimationState* self, const spAnimationStatePose* pose) {
+	int i, restored = 1;
+	const _spAnimationStatePoseHeader* header = (const _spAnimationStatePoseHeader*)pose->buffer;
+	const _spTrackPose* tracks = (const _spTrackPose*)((const char*)pose->buffer + _tracksOffset());
+
+	if (header->version != POSE_VERSION) return 0;
+
+	for (i = 0; i < header->tracksCount; ++i) {
+		const _spTrackPose* track = tracks + i;
+		spTrackEntry* entry = i < self->tracksCount ? self->tracks[i] : 0;
+		if (_spTrackEntry_getSerial(entry) != track->entrySerial) {
+			restored = 0;
+			continue;
+		}
+		if (!entry) continue;
+		if (entry->animation != track->animation || _spTrackEntry_getSerial(entry->previous) != track->previousSerial) {
+			restored = 0;
+			continue;
+		}
+		entry->time = track->time;
+		entry->lastTime = track->lastTime;
+		entry->mixTime = track->mixTime;
+		if (entry->previous) entry->previous->time = track->previousTime;
+	}
+	for (; i < self->tracksCount; ++i)
+		if (self->tracks[i]) restored = 0;
+	return restored;
+}
@@ -0,0 +1,381 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonRasterizer.h>
+#include <spine/extension.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SP_RASTERIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+typedef struct {
+	spSkeletonRasterizer super;
+	spSkeletonRenderList* renderList;
+} _spSkeletonRasterizer;
+
+/* Triangle setup, in pixels. Edge i is opposite vertex i: a * x + b * y + c is 0 on the edge and positive inside. Texture
+ * coordinates are planar in x and y, in texels. */
+typedef struct {
+	float a[3], b[3], c[3];
+	int/*bool*/topLeft[3];
+	float uA, uB, uC, vA, vB, vC;
+	int minX, minY, maxX, maxY;
+} _spTriangle;
+
+spSkeletonRasterizer* spSkeletonRasterizer_create (int width, int height) {
+	_spSkeletonRasterizer* internal = NEW(_spSkeletonRasterizer);
+	spSkeletonRasterizer* self = SUPER(internal);
+	CONST_CAST(int, self->width) = width;
+	CONST_CAST(int, self->height) = height;
+	CONST_CAST(unsigned char*, self->pixels) = CALLOC(unsigned char, width * height * 4);
+	self->scaleX = 1;
+	self->scaleY = 1;
+	internal->renderList = spSkeletonRenderList_create(1);
+	internal->renderList->premultipliedAlpha = 1;
+	return self;
+}
+
+void spSkeletonRasterizer_dispose (spSkeletonRasterizer* self) {
+	spSkeletonRenderList_dispose(SUB_CAST(_spSkeletonRasterizer, self)->renderList);
+	FREE(self->pixels);
+	FREE(self);
+}
+
+void spSkeletonRasterizer_clear (spSkeletonRasterizer* self, float r, float g, float b, float a) {
+	unsigned char color[4];
+	unsigned char* pixel = self->pixels;
+	unsigned char* end = pixel + self->width * self->height * 4;
+	color[0] = (unsigned char)(r * a * 255 + 0.5f);
+	color[1] = (unsigned char)(g * a * 255 + 0.5f);
+	color[2] = (unsigned char)(b * a * 255 + 0.5f);
+	color[3] = (unsigned char)(a * 255 + 0.5f);
+	for (; pixel != end; pixel += 4)
+		memcpy(pixel, color, 4);
+}
+
+void spSkeletonRasterizer_drawSkeleton (spSkeletonRasterizer* self, spSkeleton* skeleton) {
+	spSkeletonRenderList* renderList = SUB_CAST(_spSkeletonRasterizer, self)->renderList;
+	spSkeletonRenderList_update(renderList, skeleton);
+	spSkeletonRasterizer_drawRenderList(self, renderList);
+}
+
+/* Returns 0 if the triangle covers no pixels. */
+static int _setupTriangle (const spSkeletonRasterizer* self, const spRasterTexture* texture, const spRenderVertex* v0,
+		const spRenderVertex* v1, const spRenderVertex* v2, _spTriangle* triangle) {
+	float x[3], y[3], u[3], v[3], area, minX, minY, maxX, maxY;
+	int i;
+
+	x[0] = v0->x * self->scaleX + self->x;
+	y[0] = v0->y * self->scaleY + self->y;
+	x[1] = v1->x * self->scaleX + self->x;
+	y[1] = v1->y * self->scaleY + self->y;
+	x[2] = v2->x * self->scaleX + self->x;
+	y[2] = v2->y * self->scaleY + self->y;
+
+	area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (area == 0) return 0;
+
+	minX = x[0] < x[1] ? x[0] : x[1];
+	if (x[2] < minX) minX = x[2];
+	maxX = x[0] > x[1] ? x[0] : x[1];
+	if (x[2] > maxX) maxX = x[2];
+	minY = y[0] < y[1] ? y[0] : y[1];
+	if (y[2] < minY) minY = y[2];
+	maxY = y[0] > y[1] ? y[0] : y[1];
+	if (y[2] > maxY) maxY = y[2];
+	if (maxX < 0 || maxY < 0 || minX >= self->width || minY >= self->height) return 0;
+	triangle->minX = minX < 0 ? 0 : (int)minX;
+	triangle->minY = minY < 0 ? 0 : (int)minY;
+	triangle->maxX = maxX >= self->width ? self->width - 1 : (int)maxX;
+	triangle->maxY = maxY >= self->height ? self->height - 1 : (int)maxY;
+	if (triangle->minX > triangle->maxX || triangle->minY > triangle->maxY) return 0;
+
+	/* Texel centers are at half coordinates. */
+	u[0] = v0->u * texture->width - 0.5f;
+	v[0] = v0->v * texture->height - 0.5f;
+	u[1] = v1->u * texture->width - 0.5f;
+	v[1] = v1->v * texture->height - 0.5f;
+	u[2] = v2->u * texture->width - 0.5f;
+	v[2] = v2->v * texture->height - 0.5f;
+
+	triangle->uA = triangle->uB = triangle->uC = 0;
+	triangle->vA = triangle->vB = triangle->vC = 0;
+	for (i = 0; i < 3; ++i) {
+		int j = i == 2 ? 0 : i + 1, k = j == 2 ? 0 : j + 1;
+		float a = y[j] - y[k], b = x[k] - x[j], c = x[j] * y[k] - x[k] * y[j];
+		if (area < 0) {
+			a = -a;
+			b = -b;
+			c = -c;
+		}
+		triangle->a[i] = a;
+		triangle->b[i] = b;
+		triangle->c[i] = c;
+		/* An edge shared by two triangles has opposite signs in each, so exactly one of them owns its pixels. */
+		triangle->topLeft[i] = a > 0 || (a == 0 && b > 0);
+		triangle->uA += a * u[i];
+		triangle->uB += b * u[i];
+		triangle->uC += c * u[i];
+		triangle->vA += a * v[i];
+		triangle->vB += b * v[i];
+		triangle->vC += c * v[i];
+	}
+	if (area < 0) area = -area;
+	triangle->uA /= area;
+	triangle->uB /= area;
+	triangle->uC /= area;
+	triangle->vA /= area;
+	triangle->vB /= area;
+	triangle->vC /= area;
+	return 1;
+}
+
+/* Returns the 4 texels around u, v, clamped to the texture edges. */
+static void _texels (const spRasterTexture* texture, float u, float v, const unsigned char** texels, float* fx, float* fy) {
+	float floorU = (float)floor(u), floorV = (float)floor(v);
+	int x0 = (int)floorU, y0 = (int)floorV, x1 = x0 + 1, y1 = y0 + 1;
+	int maxX = texture->width - 1, maxY = texture->height - 1;
+	*fx = u - floorU;
+	*fy = v - floorV;
+	if (x0 < 0) x0 = 0; else if (x0 > maxX) x0 = maxX;
+	if (x1 < 0) x1 = 0; else if (x1 > maxX) x1 = maxX;
+	if (y0 < 0) y0 = 0; else if (y0 > maxY) y0 = maxY;
+	if (y1 < 0) y1 = 0; else if (y1 > maxY) y1 = maxY;
+	texels[0] = texture->pixels + (y0 * texture->width + x0) * 4;
+	texels[1] = texture->pixels + (y0 * texture->width + x1) * 4;
+	texels[2] = texture->pixels + (y1 * texture->width + x0) * 4;
+	texels[3] = texture->pixels + (y1 * texture->width + x1) * 4;
+}
+
+#ifdef SP_RASTERIZER_SSE2
+
+/* RGBA bytes to 4 floats from 0 to 255. */
+static __m128 _load (const unsigned char* rgba) {
+	int value;
+	__m128i zero = _mm_setzero_si128();
+	memcpy(&value, rgba, 4);
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero));
+}
+
+static __m128 _loadPremultiplied (const unsigned char* rgba, int/*bool*/premultipliedAlpha) {
+	__m128 texel = _load(rgba);
+	if (!premultipliedAlpha) {
+		__m128 alpha = _mm_shuffle_ps(texel, texel, _MM_SHUFFLE(3, 3, 3, 3));
+		texel = _mm_mul_ps(texel,
+				_mm_add_ps(_mm_mul_ps(alpha, _mm_set_ps(0, 1 / 255.0f, 1 / 255.0f, 1 / 255.0f)), _mm_set_ps(1, 0, 0, 0)));
+	}
+	return texel;
+}
+
+static __m128 _sample (const spRasterTexture* texture, int/*bool*/premultipliedAlpha, float u, float v) {
+	const unsigned char* texels[4];
+	float fx, fy;
+	__m128 wx, wy, top, bottom;
+	_texels(texture, u, v, texels, &fx, &fy);
+	wx = _mm_set1_ps(fx);
+	wy = _mm_set1_ps(fy);
+	top = _loadPremultiplied(texels[0], premultipliedAlpha);
+	top = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(_loadPremultiplied(texels[1], premultipliedAlpha), top), wx));
+	bottom = _loadPremultiplied(texels[2], premultipliedAlpha);
+	bottom = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(_loadPremultiplied(texels[3], premultipliedAlpha), bottom), wx));
+	return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), wy));
+}
+
+/* Blends a premultiplied color, components from 0 to 255, into the pixel. */
+static void _blend (unsigned char* pixel, __m128 src, spBlendMode blendMode) {
+	const __m128 one = _mm_set1_ps(1), inv255 = _mm_set1_ps(1 / 255.0f);
+	__m128 dst = _load(pixel), result;
+	__m128 invSrcAlpha = _mm_sub_ps(one, _mm_mul_ps(_mm_shuffle_ps(src, src, _MM_SHUFFLE(3, 3, 3, 3)), inv255));
+	__m128i packed;
+	int value;
+	switch (blendMode) {
+	case SP_BLEND_MODE_ADDITIVE:
+		result = _mm_add_ps(src, dst);
+		break;
+	case SP_BLEND_MODE_MULTIPLY:
+		result = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(src, dst), inv255), _mm_mul_ps(dst, invSrcAlpha));
+		break;
+	case SP_BLEND_MODE_SCREEN:
+		result = _mm_add_ps(src, _mm_mul_ps(dst, _mm_sub_ps(one, _mm_mul_ps(src, inv255))));
+		break;
+	default:
+		result = _mm_add_ps(src, _mm_mul_ps(dst, invSrcAlpha));
+	}
+	result = _mm_min_ps(result, _mm_set1_ps(255));
+	packed = _mm_cvtps_epi32(result);
+	packed = _mm_packus_epi16(_mm_packs_epi32(packed, packed), packed);
+	value = _mm_cvtsi128_si32(packed);
+	memcpy(pixel, &value, 4);
+}
+
+/* Evaluates the edges and texture coordinates for 4 pixels of a row at a time. */
+static void _drawTriangle (spSkeletonRasterizer* self, const spRasterTexture* texture, spBlendMode blendMode,
+		const _spTriangle* triangle, const float* color) {
+	const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f), zero = _mm_setzero_ps();
+	__m128 colorScale = _mm_loadu_ps(color), a[3], uA, vA;
+	float us[4], vs[4];
+	int x, y, i, mask, lastMask;
+
+	for (i = 0; i < 3; ++i)
+		a[i] = _mm_set1_ps(triangle->a[i]);
+	uA = _mm_set1_ps(triangle->uA);
+	vA = _mm_set1_ps(triangle->vA);
+	for (y = triangle->minY; y <= triangle->maxY; ++y) {
+		float py = y + 0.5f;
+		unsigned char* row = self->pixels + y * self->width * 4;
+		for (x = triangle->minX; x <= triangle->maxX; x += 4) {
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+			mask = 0xF;
+			for (i = 0; i < 3; ++i) {
+				__m128 w = _mm_add_ps(_mm_mul_ps(a[i], px), _mm_set1_ps(triangle->b[i] * py + triangle->c[i]));
+				mask &= _mm_movemask_ps(triangle->topLeft[i] ? _mm_cmpge_ps(w, zero) : _mm_cmpgt_ps(w, zero));
+			}
+			lastMask = triangle->maxX - x;
+			if (lastMask < 3) mask &= (1 << (lastMask + 1)) - 1;
+			if (!mask) continue;
+			_mm_storeu_ps(us, _mm_add_ps(_mm_mul_ps(uA, px), _mm_set1_ps(triangle->uB * py + triangle->uC)));
+			_mm_storeu_ps(vs, _mm_add_ps(_mm_mul_ps(vA, px), _mm_set1_ps(triangle->vB * py + triangle->vC)));
+			for (i = 0; i < 4; ++i) {
+				if (!(mask & (1 << i))) continue;
+				_blend(row + (x + i) * 4, _mm_mul_ps(_sample(texture, self->premultipliedAlpha, us[i], vs[i]), colorScale),
+						blendMode);
+			}
+		}
+	}
+}
+
+#else
+
+static void _sample (const spRasterTexture* texture, int/*bool*/premultipliedAlpha, float u, float v, float* out) {
+	const unsigned char* texels[4];
+	float fx, fy, texel[4][4];
+	int i, ii;
+	_texels(texture, u, v, texels, &fx, &fy);
+	for (i = 0; i < 4; ++i) {
+		float alpha = premultipliedAlpha ? 255 : texels[i][3];
+		for (ii = 0; ii < 3; ++ii)
+			texel[i][ii] = texels[i][ii] * alpha / 255;
+		texel[i][3] = texels[i][3];
+	}
+	for (i = 0; i < 4; ++i) {
+		float top = texel[0][i] + (texel[1][i] - texel[0][i]) * fx;
+		float bottom = texel[2][i] + (texel[3][i] - texel[2][i]) * fx;
+		out[i] = top + (bottom - top) * fy;
+	}
+}
+
+/* Blends a premultiplied color, components from 0 to 255, into the pixel. */
+static void _blend (unsigned char* pixel, const float* src, spBlendMode blendMode) {
+	float invSrcAlpha = 1 - src[3] / 255;
+	int i;
+	for (i = 0; i < 4; ++i) {
+		float dst = pixel[i], result;
+		switch (blendMode) {
+		case SP_BLEND_MODE_ADDITIVE:
+			result = src[i] + dst;
+			break;
+		case SP_BLEND_MODE_MULTIPLY:
+			result = src[i] * dst / 255 + dst * invSrcAlpha;
+			break;
+		case SP_BLEND_MODE_SCREEN:
+			result = src[i] + dst * (1 - src[i] / 255);
+			break;
+		default:
+			result = src[i] + dst * invSrcAlpha;
+		}
+		pixel[i] = result >= 255 ? 255 : (unsigned char)(result + 0.5f);
+	}
+}
+
+static void _drawTriangle (spSkeletonRasterizer* self, const spRasterTexture* texture, spBlendMode blendMode,
+		const _spTriangle* triangle, const float* color) {
+	float src[4];
+	int x, y, i;
+	for (y = triangle->minY; y <= triangle->maxY; ++y) {
+		float py = y + 0.5f;
+		unsigned char* row = self->pixels + y * self->width * 4;
+		for (x = triangle->minX; x <= triangle->maxX; ++x) {
+			float px = x + 0.5f;
+			for (i = 0; i < 3; ++i) {
+				float w = triangle->a[i] * px + triangle->b[i] * py + triangle->c[i];
+				if (w < 0 || (w == 0 && !triangle->topLeft[i])) break;
+			}
+			if (i < 3) continue;
+			_sample(texture, self->premultipliedAlpha, triangle->uA * px + triangle->uB * py + triangle->uC,
+					triangle->vA * px + triangle->vB * py + triangle->vC, src);
+			for (i = 0; i < 4; ++i)
+				src[i] *= color[i];
+			_blend(row + x * 4, src, blendMode);
+		}
+	}
+}
+
+#endif
+
+void spSkeletonRasterizer_drawRenderList (spSkeletonRasterizer* self, const spSkeletonRenderList* renderList) {
+	_spTriangle triangle;
+	float color[4];
+	int i, ii, n;
+	for (i = 0; i < renderList->batchesCount; ++i) {
+		const spRenderBatch* batch = renderList->batches + i;
+		const spRasterTexture* texture = (const spRasterTexture*)batch->rendererObject;
+		const spRenderVertex* vertices = renderList->vertices + batch->verticesStart;
+		if (!texture || !texture->pixels) continue;
+		for (ii = batch->indicesStart, n = ii + batch->indicesCount; ii < n; ii += 3) {
+			const spRenderVertex *v0, *v1, *v2;
+			if (renderList->use32BitIndices) {
+				const unsigned int* indices = (const unsigned int*)renderList->indices + ii;
+				v0 = vertices + indices[0];
+				v1 = vertices + indices[1];
+				v2 = vertices + indices[2];
+			} else {
+				const unsigned short* indices = (const unsigned short*)renderList->indices + ii;
+				v0 = vertices + indices[0];
+				v1 = vertices + indices[1];
+				v2 = vertices + indices[2];
+			}
+			if (!_setupTriangle(self, texture, v0, v1, v2, &triangle)) continue;
+
+			/* All vertices of an attachment have the same color, so a triangle's color is constant. */
+			color[3] = v0->a / 255.0f;
+			color[0] = v0->r / 255.0f;
+			color[1] = v0->g / 255.0f;
+			color[2] = v0->b / 255.0f;
+			if (!renderList->premultipliedAlpha) {
+				color[0] *= color[3];
+				color[1] *= color[3];
+				color[2] *= color[3];
+			}
+			_drawTriangle(self, texture, batch->blendMode, &triangle, color);
+		}
+	}
+}
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonRenderList.h>
+#include <spine/extension.h>
+
+typedef struct {
+	spSkeletonRenderList super;
+
+	int verticesCapacity;
+	int indicesCapacity;
+	int batchesCapacity;
+} _spSkeletonRenderList;
+
+static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+
+spSkeletonRenderList* spSkeletonRenderList_create (int/*bool*/use32BitIndices) {
+	_spSkeletonRenderList* internal = NEW(_spSkeletonRenderList);
+	spSkeletonRenderList* self = SUPER(internal);
+	CONST_CAST(int, self->use32BitIndices) = use32BitIndices;
+	return self;
+}
+
+void spSkeletonRenderList_dispose (spSkeletonRenderList* self) {
+	FREE(self->vertices);
+	FREE(self->indices);
+	FREE(self->batches);
+	FREE(self);
+}
+
+/* Returns a larger copy of data, keeping the first count elements. */
+static void* _grow (void* data, int count, int* capacity, int minCapacity, size_t size) {
+	void* newData;
+	int newCapacity = *capacity < 16 ? 16 : *capacity;
+	while (newCapacity < minCapacity)
+		newCapacity <<= 1;
+	newData = MALLOC(char, newCapacity * size);
+	if (count) memcpy(newData, data, count * size);
+	FREE(data);
+	*capacity = newCapacity;
+	return newData;
+}
+
+void spSkeletonRenderList_update (spSkeletonRenderList* self, spSkeleton* skeleton) {
+	_spSkeletonRenderList* internal = SUB_CAST(_spSkeletonRenderList, self);
+	spRenderBatch* batch = 0;
+	float bounds[4];
+	int i, ii;
+
+	self->verticesCount = 0;
+	self->indicesCount = 0;
+	self->batchesCount = 0;
+
+	for (i = 0; i < skeleton->slotsCount; ++i) {
+		spSlot* slot = skeleton->drawOrder[i];
+		spAttachment* attachment = slot->attachment;
+		void* rendererObject;
+		const float* uvs;
+		int verticesCount;
+		const int* triangles;
+		int trianglesCount;
+		unsigned int color;
+		int verticesStart;
+		spRenderVertex* vertex;
+		const float* worldVertices;
+
+		if (!attachment) continue;
+
+		if (self->cull && spSlot_getBounds(slot, bounds)) {
+			if (bounds[2] < self->cullMinX || bounds[0] > self->cullMaxX) continue;
+			if (bounds[3] < self->cullMinY || bounds[1] > self->cullMaxY) continue;
+		}
+
+		switch (attachment->type) {
+		case SP_ATTACHMENT_REGION: {
+			spRegionAttachment* region = SUB_CAST(spRegionAttachment, attachment);
+			rendererObject = ((spAtlasRegion*)region->rendererObject)->page->rendererObject;
+			uvs = region->uvs;
+			triangles = quadTriangles;
+			trianglesCount = 6;
+			break;
+		}
+		case SP_ATTACHMENT_MESH: {
+			spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, attachment);
+			rendererObject = ((spAtlasRegion*)mesh->rendererObject)->page->rendererObject;
+			uvs = mesh->uvs;
+			triangles = mesh->triangles;
+			trianglesCount = mesh->trianglesCount;
+			break;
+		}
+		case SP_ATTACHMENT_SKINNED_MESH: {
+			spSkinnedMeshAttachment* mesh = SUB_CAST(spSkinnedMeshAttachment, attachment);
+			rendererObject = ((spAtlasRegion*)mesh->rendererObject)->page->rendererObject;
+			uvs = mesh->uvs;
+			triangles = mesh->triangles;
+			trianglesCount = mesh->trianglesCount;
+			break;
+		}
+		default:
+			continue;
+		}
+		worldVertices = spSlot_getWorldVertices(slot, &verticesCount);
+		verticesCount >>= 1;
+
+		if (!batch || batch->rendererObject != rendererObject || batch->blendMode != slot->data->blendMode
+				|| (!self->use32BitIndices && batch->verticesCount + verticesCount > 65536)) {
+			if (self->batchesCount == internal->batchesCapacity)
+				CONST_CAST(spRenderBatch*, self->batches) = _grow(self->batches, self->batchesCount, &internal->batchesCapacity,
+						self->batchesCount + 1, sizeof(spRenderBatch));
+			batch = self->batches + self->batchesCount++;
+			batch->rendererObject = rendererObject;
+			batch->blendMode = slot->data->blendMode;
+			batch->verticesStart = self->verticesCount;
+			batch->verticesCount = 0;
+			batch->indicesStart = self->indicesCount;
+			batch->indicesCount = 0;
+		}
+
+		if (self->verticesCount + verticesCount > internal->verticesCapacity)
+			CONST_CAST(spRenderVertex*, self->vertices) = _grow(self->vertices, self->verticesCount, &internal->verticesCapacity,
+					self->verticesCount + verticesCount, sizeof(spRenderVertex));
+		if (self->indicesCount + trianglesCount > internal->indicesCapacity)
+			CONST_CAST(void*, self->indices) = _grow(self->indices, self->indicesCount, &internal->indicesCapacity,
+					self->indicesCount + trianglesCount, self->use32BitIndices ? sizeof(unsigned int) : sizeof(unsigned short));
+
+		color = spSlot_getPackedColor(slot, self->premultipliedAlpha);
+
+		/* The color is copied as a single 32 bit store. */
+		vertex = self->vertices + self->verticesCount;
+		for (ii = 0; ii < verticesCount << 1; ii += 2, ++vertex) {
+			vertex->x = worldVertices[ii];
+			vertex->y = worldVertices[ii + 1];
+			memcpy(&vertex->r, &color, 4);
+			vertex->u = uvs[ii];
+			vertex->v = uvs[ii + 1];
+		}
+
+		verticesStart = batch->verticesCount;
+		if (self->use32BitIndices) {
+			unsigned int* indices = (unsigned int*)self->indices + self->indicesCount;
+			for (ii = 0; ii < trianglesCount; ++ii)
+				indices[ii] = (unsigned int)(triangles[ii] + verticesStart);
+		} else {
+			unsigned short* indices = (unsigned short*)self->indices + self->indicesCount;
+			for (ii = 0; ii < trianglesCount; ++ii)
+				indices[ii] = (unsigned short)(triangles[ii] + verticesStart);
+		}
+
+		self->verticesCount += verticesCount;
+		self->indicesCount += trianglesCount;
+		batch->verticesCount += verticesCount;
+		batch->indicesCount += trianglesCount;
+	}
+}
@@ -61,6 +61,12 @@ typedef struct {
 	_Entry* entries;
 } _spSkin;
 
+void _spSkin_addLiveBones (const spSkin* self, const spSkeleton* skeleton, int/*bool*/drawn, unsigned int* liveBones) {
+	const _Entry* entry;
+	for (entry = SUB_CAST(_spSkin, self)->entries; entry; entry = entry->next)
+		_spSkeleton_addLiveBones(skeleton, entry->slotIndex, entry->attachment, drawn, liveBones);
+}
+
 spSkin* spSkin_create (const char* name) {
 	spSkin* self = SUPER(NEW(_spSkin));
 	MALLOC_STR(self->name, name);
@@ -118,3 +124,28 @@ void spSkin_attachAll (const spSkin* self, spSkeleton* skeleton, const spSkin* o
 		entry = entry->next;
 	}
 }
+
+int spSkin_getMaxWorldVerticesCount (const spSkin* self) {
+	const _Entry* entry = SUB_CAST(_spSkin, self)->entries;
+	int max = 0;
+	while (entry) {
+		int count = 0;
+		switch (entry->attachment->type) {
+		case SP_ATTACHMENT_REGION:
+			count = 8;
+			break;
+		case SP_ATTACHMENT_MESH:
+			count = SUB_CAST(spMeshAttachment, entry->attachment)->verticesCount;
+			break;
+		case SP_ATTACHMENT_SKINNED_MESH:
+			count = SUB_CAST(spSkinnedMeshAttachment, entry->attachment)->uvsCount;
+			break;
+		case SP_ATTACHMENT_BOUNDING_BOX:
+			count = SUB_CAST(spBoundingBoxAttachment, entry->attachment)->verticesCount;
+			break;
+		}
+		if (count > max) max = count;
+		entry = entry->next;
+	}
+	return max;
+}
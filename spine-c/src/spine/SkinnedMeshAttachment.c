@@ -42,6 +42,8 @@ void _spSkinnedMeshAttachment_dispose (spAttachment* attachment) {
 	FREE(self->uvs);
 	FREE(self->triangles);
 	FREE(self->edges);
+	FREE(self->boundsBones);
+	FREE(self->boundsRadii);
 	FREE(self);
 }
 
@@ -73,6 +75,32 @@ void spSkinnedMeshAttachment_updateUVs (spSkinnedMeshAttachment* self) {
 	}
 }
 
+void spSkinnedMeshAttachment_updateBounds (spSkinnedMeshAttachment* self) {
+	int i, ii, v = 0, b = 0;
+	FREE(self->boundsBones);
+	FREE(self->boundsRadii);
+	self->boundsBonesCount = 0;
+	self->boundsBones = MALLOC(int, self->bonesCount);
+	self->boundsRadii = MALLOC(float, self->bonesCount);
+	while (v < self->bonesCount) {
+		const int nn = self->bones[v] + v;
+		v++;
+		for (; v <= nn; v++, b += 3) {
+			float radius = self->weights[b] * self->weights[b] + self->weights[b + 1] * self->weights[b + 1];
+			for (ii = 0; ii < self->boundsBonesCount; ++ii)
+				if (self->boundsBones[ii] == self->bones[v]) break;
+			if (ii == self->boundsBonesCount) {
+				self->boundsBones[ii] = self->bones[v];
+				self->boundsRadii[ii] = 0;
+				self->boundsBonesCount++;
+			}
+			if (radius > self->boundsRadii[ii]) self->boundsRadii[ii] = radius;
+		}
+	}
+	for (i = 0; i < self->boundsBonesCount; ++i)
+		self->boundsRadii[i] = SQRT(self->boundsRadii[i]);
+}
+
 void spSkinnedMeshAttachment_computeWorldVertices (spSkinnedMeshAttachment* self, spSlot* slot, float* worldVertices) {
 	int w = 0, v = 0, b = 0, f = 0;
 	float x = slot->bone->skeleton->x, y = slot->bone->skeleton->y;
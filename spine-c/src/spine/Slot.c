@@ -30,30 +30,91 @@
  *****************************************************************************/
 
 #include <spine/Slot.h>
+#include <limits.h>
 #include <spine/extension.h>
 
 typedef struct {
 	spSlot super;
 	float attachmentTime;
+
+	/* Cache for spSlot_getWorldVertices. The key is the skeleton position and the world transform of each bone. */
+	int worldVerticesCapacity;
+	int worldVerticesCount;
+	float* worldVertices;
+	const spAttachment* worldVerticesAttachment;
+	int worldVerticesVersion;
+	int worldVerticesKeyCapacity;
+	float* worldVerticesKey;
+
+	/* See _spSlot_getDeformedRange. */
+	int deformedStart, deformedEnd;
+
+	/* The index of the slot's data in the skeleton data, for the setup attachment rows. */
+	int index;
+
+	/* Cache for spSlot_getPackedColor. The key is the skeleton, slot and attachment colors. */
+	unsigned int packedColor;
+	int/*bool*/packedColorPremultipliedAlpha;
+	float packedColorKey[12];
 } _spSlot;
 
-spSlot* spSlot_create (spSlotData* data, spBone* bone) {
-	spSlot* self = SUPER(NEW(_spSlot));
+void _spSlot_init (spSlot* self, spSlotData* data, spBone* bone, int index) {
 	CONST_CAST(spSlotData*, self->data) = data;
 	CONST_CAST(spBone*, self->bone) = bone;
+	SUB_CAST(_spSlot, self)->index = index;
 	spSlot_setToSetupPose(self);
+}
+
+static void _spSlot_deinit (spSlot* self) {
+	FREE(SUB_CAST(_spSlot, self)->worldVertices);
+	FREE(SUB_CAST(_spSlot, self)->worldVerticesKey);
+	FREE(self->attachmentVertices);
+}
+
+spSlot* spSlot_create (spSlotData* data, spBone* bone) {
+	spSlot* self = SUPER(NEW(_spSlot));
+	const spSkeletonData* skeletonData = bone->skeleton->data;
+	int i;
+	for (i = 0; i < skeletonData->slotsCount; ++i)
+		if (skeletonData->slots[i] == data) break;
+	_spSlot_init(self, data, bone, i);
 	return self;
 }
 
 void spSlot_dispose (spSlot* self) {
-	FREE(self->attachmentVertices);
+	_spSlot_deinit(self);
 	FREE(self);
 }
 
+void _spSlot_createSlots (spSlot** slots, int count) {
+	int i;
+	_spSlot* block = CALLOC(_spSlot, count);
+	for (i = 0; i < count; ++i)
+		slots[i] = &block[i].super;
+}
+
+void _spSlot_disposeSlots (spSlot** slots, int count) {
+	int i;
+	for (i = 0; i < count; ++i)
+		_spSlot_deinit(slots[i]);
+	if (count) FREE(SUB_CAST(_spSlot, slots[0]));
+}
+
 void spSlot_setAttachment (spSlot* self, spAttachment* attachment) {
 	CONST_CAST(spAttachment*, self->attachment) = attachment;
 	SUB_CAST(_spSlot, self)->attachmentTime = self->bone->skeleton->time;
 	self->attachmentVerticesCount = 0;
+	self->attachmentVerticesVersion++;
+}
+
+void _spSlot_getDeformedRange (const spSlot* self, int* start, int* end) {
+	*start = SUB_CAST(_spSlot, self)->deformedStart;
+	*end = SUB_CAST(_spSlot, self)->deformedEnd;
+}
+
+void _spSlot_setDeformedRange (spSlot* self, int start, int end) {
+	SUB_CAST(_spSlot, self)->deformedStart = start;
+	SUB_CAST(_spSlot, self)->deformedEnd = end;
 }
 
 void spSlot_setAttachmentTime (spSlot* self, float time) {
@@ -72,15 +133,247 @@ void spSlot_setToSetupPose (spSlot* self) {
 	self->b = self->data->b;
 	self->a = self->data->a;
 
-	if (self->data->attachmentName) {
-		/* Find slot index. */
-		int i;
-		for (i = 0; i < self->bone->skeleton->data->slotsCount; ++i) {
-			if (self->data == self->bone->skeleton->data->slots[i]) {
-				attachment = spSkeleton_getAttachmentForSlotIndex(self->bone->skeleton, i, self->data->attachmentName);
-				break;
-			}
-		}
+	/* The index is the data's slots count for a slot whose data isn't in the skeleton data. */
+	if (self->data->attachmentName && SUB_CAST(_spSlot, self)->index < self->bone->skeleton->data->slotsCount) {
+		int index = SUB_CAST(_spSlot, self)->index;
+		spAttachment** setupAttachments = _spSkeleton_getSetupAttachments(self->bone->skeleton);
+		if (setupAttachments)
+			attachment = setupAttachments[index];
+		else
+			attachment = spSkeleton_getAttachmentForSlotIndex(self->bone->skeleton, index, self->data->attachmentName);
 	}
 	spSlot_setAttachment(self, attachment);
 }
+
+/* Adds a circle around the bone to the bounds. The radius is scaled by the bone's largest possible stretch. */
+static void _addBoneRadius (const spBone* bone, float radius, float* bounds) {
+	float x = bone->skeleton->x + bone->worldX, y = bone->skeleton->y + bone->worldY;
+	radius *= SQRT(bone->m00 * bone->m00 + bone->m01 * bone->m01 + bone->m10 * bone->m10 + bone->m11 * bone->m11);
+	if (x - radius < bounds[0]) bounds[0] = x - radius;
+	if (y - radius < bounds[1]) bounds[1] = y - radius;
+	if (x + radius > bounds[2]) bounds[2] = x + radius;
+	if (y + radius > bounds[3]) bounds[3] = y + radius;
+}
+
+/* Returns the largest length of the deform offsets or vertices. */
+static float _radius (const float* vertices, int verticesCount) {
+	float radius = 0;
+	int i;
+	for (i = 0; i < verticesCount; i += 2) {
+		float length = vertices[i] * vertices[i] + vertices[i + 1] * vertices[i + 1];
+		if (length > radius) radius = length;
+	}
+	return SQRT(radius);
+}
+
+int/*bool*/spSlot_getBounds (const spSlot* self, float* bounds) {
+	int i;
+	bounds[0] = bounds[1] = (float)INT_MAX;
+	bounds[2] = bounds[3] = (float)INT_MIN;
+	if (!self->attachment) return 0;
+	switch (self->attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		_addBoneRadius(self->bone, SUB_CAST(spRegionAttachment, self->attachment)->radius, bounds);
+		return 1;
+	case SP_ATTACHMENT_MESH: {
+		spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, self->attachment);
+		float radius = mesh->radius;
+		if (self->attachmentVerticesCount == mesh->verticesCount)
+			radius = _radius(self->attachmentVertices, self->attachmentVerticesCount);
+		else if (radius == 0) /* spMeshAttachment_updateBounds was not called, eg for a mesh built in code. */
+			radius = _radius(mesh->vertices, mesh->verticesCount);
+		_addBoneRadius(self->bone, radius, bounds);
+		return 1;
+	}
+	case SP_ATTACHMENT_SKINNED_MESH: {
+		spSkinnedMeshAttachment* mesh = SUB_CAST(spSkinnedMeshAttachment, self->attachment);
+		spBone** bones = self->bone->skeleton->bones;
+		float deform = self->attachmentVerticesCount ? _radius(self->attachmentVertices, self->attachmentVerticesCount) : 0;
+		for (i = 0; i < mesh->boundsBonesCount; ++i)
+			_addBoneRadius(bones[mesh->boundsBones[i]], mesh->boundsRadii[i] + deform, bounds);
+		return mesh->boundsBonesCount > 0;
+	}
+	default:
+		return 0;
+	}
+}
+
+/* Stores the value in the key and returns true if it differs. */
+static int _setKey (float* key, float value) {
+	if (*key == value) return 0;
+	*key = value;
+	return 1;
+}
+
+static int _setBoneKey (float* key, const spBone* bone) {
+	int changed = _setKey(key, bone->m00);
+	changed |= _setKey(key + 1, bone->m01);
+	changed |= _setKey(key + 2, bone->m10);
+	changed |= _setKey(key + 3, bone->m11);
+	changed |= _setKey(key + 4, bone->worldX);
+	changed |= _setKey(key + 5, bone->worldY);
+	return changed;
+}
+
+/* Returns false if the attachment has no world vertices. */
+static int _getWorldVerticesSize (const spAttachment* attachment, int* count, int* keyCount) {
+	*keyCount = 8;
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		*count = 8;
+		return 1;
+	case SP_ATTACHMENT_MESH:
+		*count = SUB_CAST(spMeshAttachment, attachment)->verticesCount;
+		return 1;
+	case SP_ATTACHMENT_SKINNED_MESH:
+		*count = SUB_CAST(spSkinnedMeshAttachment, attachment)->uvsCount;
+		*keyCount = 2 + 6 * SUB_CAST(spSkinnedMeshAttachment, attachment)->boundsBonesCount;
+		return 1;
+	case SP_ATTACHMENT_BOUNDING_BOX:
+		*count = SUB_CAST(spBoundingBoxAttachment, attachment)->verticesCount;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* Returns true if the cache was reallocated. */
+static int _reserveWorldVertices (_spSlot* internal, int count, int keyCount) {
+	int reallocated = 0;
+	if (internal->worldVerticesCapacity < count) {
+		FREE(internal->worldVertices);
+		internal->worldVertices = MALLOC(float, count);
+		internal->worldVerticesCapacity = count;
+		reallocated = 1;
+	}
+	if (internal->worldVerticesKeyCapacity < keyCount) {
+		FREE(internal->worldVerticesKey);
+		internal->worldVerticesKey = MALLOC(float, keyCount);
+		internal->worldVerticesKeyCapacity = keyCount;
+		reallocated = 1;
+	}
+	/* The contents are lost, so force recomputing. */
+	if (reallocated) internal->worldVerticesAttachment = 0;
+	return reallocated;
+}
+
+void _spSlot_reserveWorldVertices (spSlot* self, const spAttachment* attachment) {
+	int count, keyCount;
+	if (_getWorldVerticesSize(attachment, &count, &keyCount)) _reserveWorldVertices(SUB_CAST(_spSlot, self), count, keyCount);
+}
+
+const float* spSlot_getWorldVertices (spSlot* self, int* verticesCount) {
+	_spSlot* internal = SUB_CAST(_spSlot, self);
+	spAttachment* attachment = self->attachment;
+	spSkinnedMeshAttachment* skinnedMesh = 0;
+	int count, keyCount, changed, i;
+
+	*verticesCount = 0;
+	if (!attachment || !_getWorldVerticesSize(attachment, &count, &keyCount)) return 0;
+	if (attachment->type == SP_ATTACHMENT_SKINNED_MESH) skinnedMesh = SUB_CAST(spSkinnedMeshAttachment, attachment);
+
+	changed = _reserveWorldVertices(internal, count, keyCount);
+	changed |= attachment != internal->worldVerticesAttachment || self->attachmentVerticesVersion != internal->worldVerticesVersion;
+	/* Without bounds bones the bones a skinned mesh depends on are unknown. */
+	if (skinnedMesh && !skinnedMesh->boundsBonesCount) changed = 1;
+
+	changed |= _setKey(internal->worldVerticesKey, self->bone->skeleton->x);
+	changed |= _setKey(internal->worldVerticesKey + 1, self->bone->skeleton->y);
+	if (skinnedMesh) {
+		spBone** bones = self->bone->skeleton->bones;
+		for (i = 0; i < skinnedMesh->boundsBonesCount; ++i)
+			changed |= _setBoneKey(internal->worldVerticesKey + 2 + 6 * i, bones[skinnedMesh->boundsBones[i]]);
+	} else
+		changed |= _setBoneKey(internal->worldVerticesKey + 2, self->bone);
+
+	if (changed) {
+		switch (attachment->type) {
+		case SP_ATTACHMENT_REGION:
+			spRegionAttachment_computeWorldVertices(SUB_CAST(spRegionAttachment, attachment), self->bone, internal->worldVertices);
+			break;
+		case SP_ATTACHMENT_MESH:
+			spMeshAttachment_computeWorldVertices(SUB_CAST(spMeshAttachment, attachment), self, internal->worldVertices);
+			break;
+		case SP_ATTACHMENT_SKINNED_MESH:
+			spSkinnedMeshAttachment_computeWorldVertices(skinnedMesh, self, internal->worldVertices);
+			break;
+		default:
+			spBoundingBoxAttachment_computeWorldVertices(SUB_CAST(spBoundingBoxAttachment, attachment), self->bone,
+					internal->worldVertices);
+		}
+		internal->worldVerticesAttachment = attachment;
+		internal->worldVerticesVersion = self->attachmentVerticesVersion;
+	}
+	*verticesCount = count;
+	return internal->worldVertices;
+}
+
+unsigned int spSlot_getPackedColor (spSlot* self, int/*bool*/premultipliedAlpha) {
+	_spSlot* internal = SUB_CAST(_spSlot, self);
+	const spSkeleton* skeleton = self->bone->skeleton;
+	float* key = internal->packedColorKey;
+	float r = 1, g = 1, b = 1, a = 1;
+	int changed;
+
+	if (self->attachment) {
+		switch (self->attachment->type) {
+		case SP_ATTACHMENT_REGION: {
+			spRegionAttachment* region = SUB_CAST(spRegionAttachment, self->attachment);
+			r = region->r;
+			g = region->g;
+			b = region->b;
+			a = region->a;
+			break;
+		}
+		case SP_ATTACHMENT_MESH: {
+			spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, self->attachment);
+			r = mesh->r;
+			g = mesh->g;
+			b = mesh->b;
+			a = mesh->a;
+			break;
+		}
+		case SP_ATTACHMENT_SKINNED_MESH: {
+			spSkinnedMeshAttachment* mesh = SUB_CAST(spSkinnedMeshAttachment, self->attachment);
+			r = mesh->r;
+			g = mesh->g;
+			b = mesh->b;
+			a = mesh->a;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	changed = premultipliedAlpha != internal->packedColorPremultipliedAlpha;
+	changed |= _setKey(key, skeleton->r);
+	changed |= _setKey(key + 1, skeleton->g);
+	changed |= _setKey(key + 2, skeleton->b);
+	changed |= _setKey(key + 3, skeleton->a);
+	changed |= _setKey(key + 4, self->r);
+	changed |= _setKey(key + 5, self->g);
+	changed |= _setKey(key + 6, self->b);
+	changed |= _setKey(key + 7, self->a);
+	changed |= _setKey(key + 8, r);
+	changed |= _setKey(key + 9, g);
+	changed |= _setKey(key + 10, b);
+	changed |= _setKey(key + 11, a);
+
+	if (changed) {
+		unsigned char color[4];
+		float multiplier;
+		r *= skeleton->r * self->r;
+		g *= skeleton->g * self->g;
+		b *= skeleton->b * self->b;
+		a *= skeleton->a * self->a;
+		multiplier = premultipliedAlpha ? a * 255 : 255;
+		color[0] = (unsigned char)(r * multiplier);
+		color[1] = (unsigned char)(g * multiplier);
+		color[2] = (unsigned char)(b * multiplier);
+		color[3] = (unsigned char)(a * 255);
+		memcpy(&internal->packedColor, color, 4);
+		internal->packedColorPremultipliedAlpha = premultipliedAlpha;
+	}
+	return internal->packedColor;
+}
@@ -35,8 +35,11 @@
 static void* (*mallocFunc) (size_t size) = malloc;
 static void* (*debugMallocFunc) (size_t size, const char* file, int line) = NULL;
 static void (*freeFunc) (void* ptr) = free;
+static void (*allocationListener) (size_t size, const char* file, int line) = NULL;
 
 void* _malloc (size_t size, const char* file, int line) {
+	if (allocationListener)
+		allocationListener(size, file, line);
 	if(debugMallocFunc)
 		return debugMallocFunc(size, file, line);
 
@@ -62,6 +65,52 @@ void _setFree (void (*free) (void* ptr)) {
 	freeFunc = free;
 }
 
+void _setAllocationListener (void (*listener) (size_t size, const char* file, int line)) {
+	allocationListener = listener;
+}
+
+void _spSinCos (float radians, float* sine, float* cosine) {
+#ifdef SPINE_FAST_TRIG
+	/* Reduce to r in [-pi/4, pi/4] and the quadrant, then use Taylor polynomials, which are within 4e-7 on that range. */
+	int quadrant = (int)(radians * (2 / PI) + (radians < 0 ? -0.5f : 0.5f));
+	float k = (float)quadrant;
+	float r = (radians - k * 1.5703125f) - k * 4.8382679e-4f; /* pi/2 in two parts, so k * pi/2 loses less precision. */
+	float r2 = r * r;
+	float s = r + r * r2 * (-1.6666667e-1f + r2 * (8.3333333e-3f + r2 * -1.9841270e-4f));
+	float c = 1 + r2 * (-0.5f + r2 * (4.1666667e-2f + r2 * (-1.3888889e-3f + r2 * 2.4801587e-5f)));
+	switch (quadrant & 3) {
+	case 0:
+		*sine = s;
+		*cosine = c;
+		break;
+	case 1:
+		*sine = c;
+		*cosine = -s;
+		break;
+	case 2:
+		*sine = -s;
+		*cosine = -c;
+		break;
+	default:
+		*sine = -c;
+		*cosine = s;
+	}
+#else
+	*sine = SIN(radians);
+	*cosine = COS(radians);
+#endif
+}
+
+float _spWrapDegrees (float degrees) {
+	/* Without branches for differences up to 540 degrees, which is all that angles between keys or poses usually have. */
+	degrees -= 360 * ((degrees > 180) - (degrees < -180));
+	while (degrees > 180)
+		degrees -= 360;
+	while (degrees < -180)
+		degrees += 360;
+	return degrees;
+}
+
 char* _readFile (const char* path, int* length) {
 	char *data;
 	FILE *file = fopen(path, "rb");
@@ -41,6 +41,10 @@ using std::vector;
 
 namespace spine {
 
+// The most fixed steps an update applies. The time of a longer frame, eg after a stall, is dropped rather than catching up with
+// many steps that would each fire their events.
+static const int MAX_FIXED_STEPS = 4;
+
 void animationCallback (spAnimationState* state, int trackIndex, spEventType type, spEvent* event, int loopCount) {
 	((SkeletonAnimation*)state->rendererObject)->onAnimationStateEvent(trackIndex, type, event, loopCount);
 }
@@ -56,16 +60,33 @@ typedef struct _TrackEntryListeners {
 	EventListener eventListener;
 } _TrackEntryListeners;
 
+// Listeners of disposed track entries, reused so setting track listeners doesn't allocate once warmed up. Track entries are
+// only disposed on the main thread. Never freed, as nodes may be destroyed after static destructors run.
+static vector<_TrackEntryListeners*>& getListenersPool () {
+	static vector<_TrackEntryListeners*>* pool = new vector<_TrackEntryListeners*>();
+	return *pool;
+}
+
 static _TrackEntryListeners* getListeners (spTrackEntry* entry) {
 	if (!entry->rendererObject) {
-		entry->rendererObject = NEW(spine::_TrackEntryListeners);
+		vector<_TrackEntryListeners*>& pool = getListenersPool();
+		if (pool.empty())
+			entry->rendererObject = new _TrackEntryListeners();
+		else {
+			entry->rendererObject = pool.back();
+			pool.pop_back();
+		}
 		entry->listener = trackEntryCallback;
 	}
 	return (_TrackEntryListeners*)entry->rendererObject;
 }
 
 void disposeTrackEntry (spTrackEntry* entry) {
-	if (entry->rendererObject) FREE(entry->rendererObject);
+	if (entry->rendererObject) {
+		_TrackEntryListeners* listeners = (_TrackEntryListeners*)entry->rendererObject;
+		*listeners = _TrackEntryListeners();
+		getListenersPool().push_back(listeners);
+	}
 	_spTrackEntry_dispose(entry);
 }
 
@@ -91,6 +112,8 @@ SkeletonAnimation* SkeletonAnimation::createWithFile (const char* skeletonDataFi
 
 void SkeletonAnimation::initialize () {
 	ownsAnimationStateData = true;
+	fixedTimeStep = 0;
+	accumulatedTime = 0;
 	state = spAnimationState_create(spAnimationStateData_create(skeleton->data));
 	state->rendererObject = this;
 	state->listener = animationCallback;
@@ -122,10 +145,30 @@ SkeletonAnimation::~SkeletonAnimation () {
 void SkeletonAnimation::update (float deltaTime) {
 	super::update(deltaTime);
 
-	deltaTime *= timeScale;
-	spAnimationState_update(state, deltaTime);
-	spAnimationState_apply(state, skeleton);
-	spSkeleton_updateWorldTransform(skeleton);
+	if (fixedTimeStep <= 0) {
+		if (interpolator) {
+			spSkeletonInterpolator_dispose(interpolator);
+			interpolator = 0;
+		}
+		spAnimationState_update(state, deltaTime * timeScale);
+		spAnimationState_apply(state, skeleton);
+		spSkeleton_updateWorldTransform(skeleton);
+		return;
+	}
+
+	if (!interpolator) {
+		interpolator = spSkeletonInterpolator_create(skeleton);
+		accumulatedTime = 0;
+	}
+	accumulatedTime = min(accumulatedTime + deltaTime, fixedTimeStep * MAX_FIXED_STEPS);
+	while (accumulatedTime >= fixedTimeStep) {
+		accumulatedTime -= fixedTimeStep;
+		spAnimationState_update(state, fixedTimeStep * timeScale);
+		spAnimationState_apply(state, skeleton);
+		spSkeleton_updateWorldTransform(skeleton);
+		spSkeletonInterpolator_capture(interpolator);
+	}
+	interpolationAlpha = accumulatedTime / fixedTimeStep;
 }
 
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
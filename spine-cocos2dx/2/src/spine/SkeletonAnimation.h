@@ -48,6 +48,9 @@ typedef std::function<void(int trackIndex, spEvent* event)> EventListener;
 class SkeletonAnimation: public SkeletonRenderer {
 public:
 	spAnimationState* state;
+	/** When greater than 0, animations are applied at this fixed interval, in seconds, and draw interpolates between the two
+	 * most recent poses. At most 4 steps are applied per update and any further time is dropped. */
+	float fixedTimeStep;
 
 	static SkeletonAnimation* createWithData (spSkeletonData* skeletonData);
 	static SkeletonAnimation* createWithFile (const char* skeletonDataFile, spAtlas* atlas, float scale = 0);
@@ -88,6 +91,7 @@ protected:
 private:
 	typedef SkeletonRenderer super;
 	bool ownsAnimationStateData;
+	float accumulatedTime;
 
 	void initialize ();
 };
@@ -32,7 +32,6 @@
 #include <spine/SkeletonRenderer.h>
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
-#include <spine/PolygonBatch.h>
 #include <algorithm>
 
 USING_NS_CC;
@@ -41,7 +40,18 @@ using std::max;
 
 namespace spine {
 
-static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+// The render list splits batches before 16-bit indices overflow, but a single attachment with more vertices than 16-bit
+// indices can address can't be split. OpenGL ES only has 32-bit indices with an extension.
+static bool use32BitIndices (const spSkeletonData* skeletonData) {
+	if (spSkeletonData_getMaxWorldVerticesCount(skeletonData) / 2 <= 65536) return false;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+	return true;
+#else
+	if (CCConfiguration::sharedConfiguration()->checkForGLExtension("GL_OES_element_index_uint")) return true;
+	CCLOG("Skeleton has an attachment with more than 65536 vertices, but 32-bit indices are not supported.");
+	return false;
+#endif
+}
 
 SkeletonRenderer* SkeletonRenderer::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonRenderer* node = new SkeletonRenderer(skeletonData, ownsSkeletonData);
@@ -62,10 +72,7 @@ SkeletonRenderer* SkeletonRenderer::createWithFile (const char* skeletonDataFile
 }
 
 void SkeletonRenderer::initialize () {
-	worldVertices = MALLOC(float, 1000); // Max number of vertices per mesh.
-
-	batch = PolygonBatch::createWithCapacity(2000); // Max number of vertices and triangles per batch.
-	batch->retain();
+	renderList = spSkeletonRenderList_create(false);
 
 	blendFunc.src = GL_ONE;
 	blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
@@ -79,22 +86,27 @@ void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsS
 	skeleton = spSkeleton_create(skeletonData);
 	rootBone = skeleton->bones[0];
 	this->ownsSkeletonData = ownsSkeletonData;
+
+	if (use32BitIndices(skeletonData)) {
+		spSkeletonRenderList_dispose(renderList);
+		renderList = spSkeletonRenderList_create(true);
+	}
 }
 
 SkeletonRenderer::SkeletonRenderer ()
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), debugSlots(false), debugBones(false), timeScale(1), interpolator(0), interpolationAlpha(1) {
 	initialize();
 }
 
 SkeletonRenderer::SkeletonRenderer (spSkeletonData *skeletonData, bool ownsSkeletonData)
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), debugSlots(false), debugBones(false), timeScale(1), interpolator(0), interpolationAlpha(1) {
 	initialize();
 
 	setSkeletonData(skeletonData, ownsSkeletonData);
 }
 
 SkeletonRenderer::SkeletonRenderer (const char* skeletonDataFile, spAtlas* atlas, float scale)
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), debugSlots(false), debugBones(false), timeScale(1), interpolator(0), interpolationAlpha(1) {
 	initialize();
 
 	spSkeletonJson* json = spSkeletonJson_create(atlas);
@@ -107,7 +119,7 @@ SkeletonRenderer::SkeletonRenderer (const char* skeletonDataFile, spAtlas* atlas
 }
 
 SkeletonRenderer::SkeletonRenderer (const char* skeletonDataFile, const char* atlasFile, float scale)
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), debugSlots(false), debugBones(false), timeScale(1), interpolator(0), interpolationAlpha(1) {
 	initialize();
 
 	atlas = spAtlas_createFromFile(atlasFile, 0);
@@ -126,8 +138,8 @@ SkeletonRenderer::~SkeletonRenderer () {
 	if (ownsSkeletonData) spSkeletonData_dispose(skeleton->data);
 	if (atlas) spAtlas_dispose(atlas);
 	spSkeleton_dispose(skeleton);
-	FREE(worldVertices);
-	batch->release();
+	spSkeletonRenderList_dispose(renderList);
+	if (interpolator) spSkeletonInterpolator_dispose(interpolator);
 }
 
 void SkeletonRenderer::update (float deltaTime) {
@@ -135,6 +147,26 @@ void SkeletonRenderer::update (float deltaTime) {
 }
 
 void SkeletonRenderer::draw () {
+	// Culling, the render list and the debug geometry all use the interpolated pose.
+	if (interpolator) spSkeletonInterpolator_apply(interpolator, interpolationAlpha);
+
+	// Skip the skeleton when it is off screen and let the render list skip slots that are off screen. The bounds are
+	// conservative and much cheaper to compute than the vertices.
+	CCDirector* director = CCDirector::sharedDirector();
+	CCRect visibleRect = CCRectApplyAffineTransform(CCRect(director->getVisibleOrigin().x, director->getVisibleOrigin().y,
+		director->getVisibleSize().width, director->getVisibleSize().height), worldToNodeTransform());
+	float bounds[4];
+	if (spSkeleton_getBounds(skeleton, bounds) && (bounds[2] < visibleRect.getMinX() || bounds[0] > visibleRect.getMaxX()
+			|| bounds[3] < visibleRect.getMinY() || bounds[1] > visibleRect.getMaxY())) {
+		if (interpolator) spSkeletonInterpolator_restore(interpolator);
+		return;
+	}
+	renderList->cull = true;
+	renderList->cullMinX = visibleRect.getMinX();
+	renderList->cullMinY = visibleRect.getMinY();
+	renderList->cullMaxX = visibleRect.getMaxX();
+	renderList->cullMaxY = visibleRect.getMaxY();
+
 	CC_NODE_DRAW_SETUP();
 	ccGLBindVAO(0);
 
@@ -144,88 +176,46 @@ void SkeletonRenderer::draw () {
 	skeleton->b = nodeColor.b / (float)255;
 	skeleton->a = getDisplayedOpacity() / (float)255;
 
+	renderList->premultipliedAlpha = premultipliedAlpha;
+	spSkeletonRenderList_update(renderList, skeleton);
+
+	if (renderList->batchesCount) {
+		glEnableVertexAttribArray(kCCVertexAttrib_Position);
+		glEnableVertexAttribArray(kCCVertexAttrib_Color);
+		glEnableVertexAttribArray(kCCVertexAttrib_TexCoords);
+	}
 	int blendMode = -1;
-	ccColor4B color;
-	const float* uvs = nullptr;
-	int verticesCount = 0;
-	const int* triangles = nullptr;
-	int trianglesCount = 0;
-	float r = 0, g = 0, b = 0, a = 0;
-	for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
-		spSlot* slot = skeleton->drawOrder[i];
-		if (!slot->attachment) continue;
-		CCTexture2D *texture = nullptr;
-		switch (slot->attachment->type) {
-		case SP_ATTACHMENT_REGION: {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = 8;
-			triangles = quadTriangles;
-			trianglesCount = 6;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_MESH: {
-			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(attachment, slot, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->verticesCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_SKINNED_MESH: {
-			spSkinnedMeshAttachment* attachment = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(attachment, slot, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->uvsCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		}
-		if (texture) {
-			if (slot->data->blendMode != blendMode) {
-				batch->flush();
-				blendMode = slot->data->blendMode;
-				switch (slot->data->blendMode) {
-				case SP_BLEND_MODE_ADDITIVE:
-					ccGLBlendFunc(premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
-					break;
-				case SP_BLEND_MODE_MULTIPLY:
-					ccGLBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
-					break;
-				case SP_BLEND_MODE_SCREEN:
-					ccGLBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-					break;
-				default:
-					ccGLBlendFunc(blendFunc.src, blendFunc.dst);
-				}
+	for (int i = 0, n = renderList->batchesCount; i < n; i++) {
+		spRenderBatch* batch = renderList->batches + i;
+		if (batch->blendMode != blendMode) {
+			blendMode = batch->blendMode;
+			switch (batch->blendMode) {
+			case SP_BLEND_MODE_ADDITIVE:
+				ccGLBlendFunc(premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
+				break;
+			case SP_BLEND_MODE_MULTIPLY:
+				ccGLBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
+				break;
+			case SP_BLEND_MODE_SCREEN:
+				ccGLBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+				break;
+			default:
+				ccGLBlendFunc(blendFunc.src, blendFunc.dst);
 			}
-			color.a = skeleton->a * slot->a * a * 255;
-			float multiplier = premultipliedAlpha ? color.a : 255;
-			color.r = skeleton->r * slot->r * r * multiplier;
-			color.g = skeleton->g * slot->g * g * multiplier;
-			color.b = skeleton->b * slot->b * b * multiplier;
-			batch->add(texture, worldVertices, uvs, verticesCount, triangles, trianglesCount, &color);
 		}
+		ccGLBindTexture2D(((CCTexture2D*)batch->rendererObject)->getName());
+
+		// spRenderVertex has the same layout as ccV2F_C4B_T2F.
+		const spRenderVertex* vertices = renderList->vertices + batch->verticesStart;
+		glVertexAttribPointer(kCCVertexAttrib_Position, 2, GL_FLOAT, GL_FALSE, sizeof(spRenderVertex), &vertices->x);
+		glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(spRenderVertex), &vertices->r);
+		glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(spRenderVertex), &vertices->u);
+		if (renderList->use32BitIndices)
+			glDrawElements(GL_TRIANGLES, batch->indicesCount, GL_UNSIGNED_INT, (GLuint*)renderList->indices + batch->indicesStart);
+		else
+			glDrawElements(GL_TRIANGLES, batch->indicesCount, GL_UNSIGNED_SHORT, (GLushort*)renderList->indices + batch->indicesStart);
 	}
-	batch->flush();
+	CHECK_GL_ERROR_DEBUG();
 
 	if (debugSlots) {
 		// Slots.
@@ -235,8 +225,8 @@ void SkeletonRenderer::draw () {
 		for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
 			spSlot* slot = skeleton->drawOrder[i];
 			if (!slot->attachment || slot->attachment->type != SP_ATTACHMENT_REGION) continue;
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
+			int verticesCount;
+			const float* worldVertices = spSlot_getWorldVertices(slot, &verticesCount);
 			points[0] = ccp(worldVertices[0], worldVertices[1]);
 			points[1] = ccp(worldVertices[2], worldVertices[3]);
 			points[2] = ccp(worldVertices[4], worldVertices[5]);
@@ -263,18 +253,8 @@ void SkeletonRenderer::draw () {
 			if (i == 0) ccDrawColor4B(0, 255, 0, 255);
 		}
 	}
-}
-
-CCTexture2D* SkeletonRenderer::getTexture (spRegionAttachment* attachment) const {
-	return (CCTexture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
-
-CCTexture2D* SkeletonRenderer::getTexture (spMeshAttachment* attachment) const {
-	return (CCTexture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
 
-CCTexture2D* SkeletonRenderer::getTexture (spSkinnedMeshAttachment* attachment) const {
-	return (CCTexture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+	if (interpolator) spSkeletonInterpolator_restore(interpolator);
 }
 
 CCRect SkeletonRenderer::boundingBox () {
@@ -282,22 +262,9 @@ CCRect SkeletonRenderer::boundingBox () {
 	float scaleX = getScaleX(), scaleY = getScaleY();
 	for (int i = 0; i < skeleton->slotsCount; ++i) {
 		spSlot* slot = skeleton->slots[i];
-		if (!slot->attachment) continue;
+		if (!slot->attachment || slot->attachment->type == SP_ATTACHMENT_BOUNDING_BOX) continue;
 		int verticesCount;
-		if (slot->attachment->type == SP_ATTACHMENT_REGION) {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
-			verticesCount = 8;
-		} else if (slot->attachment->type == SP_ATTACHMENT_MESH) {
-			spMeshAttachment* mesh = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-			verticesCount = mesh->verticesCount;
-		} else if (slot->attachment->type == SP_ATTACHMENT_SKINNED_MESH) {
-			spSkinnedMeshAttachment* mesh = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-			verticesCount = mesh->uvsCount;
-		} else
-			continue;
+		const float* worldVertices = spSlot_getWorldVertices(slot, &verticesCount);
 		for (int ii = 0; ii < verticesCount; ii += 2) {
 			float x = worldVertices[ii] * scaleX, y = worldVertices[ii + 1] * scaleY;
 			minX = min(minX, x);
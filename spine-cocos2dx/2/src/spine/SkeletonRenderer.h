@@ -37,8 +37,6 @@
 
 namespace spine {
 
-class PolygonBatch;
-
 /** Draws a skeleton. */
 class SkeletonRenderer: public cocos2d::CCNodeRGBA, public cocos2d::CCBlendProtocol {
 public:
@@ -95,15 +93,14 @@ protected:
 	SkeletonRenderer ();
 	void setSkeletonData (spSkeletonData* skeletonData, bool ownsSkeletonData);
 
-	virtual cocos2d::CCTexture2D* getTexture (spRegionAttachment* attachment) const;
-	virtual cocos2d::CCTexture2D* getTexture (spMeshAttachment* attachment) const;
-	virtual cocos2d::CCTexture2D* getTexture (spSkinnedMeshAttachment* attachment) const;
+	// When not null, draw renders the pose interpolated by interpolationAlpha, see SkeletonAnimation::fixedTimeStep.
+	spSkeletonInterpolator* interpolator;
+	float interpolationAlpha;
 
 private:
 	bool ownsSkeletonData;
 	spAtlas* atlas;
-	PolygonBatch* batch;
-	float* worldVertices;
+	spSkeletonRenderList* renderList;
 	void initialize ();
 };
 
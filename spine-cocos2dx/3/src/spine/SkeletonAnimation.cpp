@@ -41,6 +41,10 @@ using std::vector;
 
 namespace spine {
 
+// The most fixed steps an update applies. The time of a longer frame, eg after a stall, is dropped rather than catching up with
+// many steps that would each fire their events.
+static const int MAX_FIXED_STEPS = 4;
+
 void animationCallback (spAnimationState* state, int trackIndex, spEventType type, spEvent* event, int loopCount) {
 	((SkeletonAnimation*)state->rendererObject)->onAnimationStateEvent(trackIndex, type, event, loopCount);
 }
@@ -56,16 +60,33 @@ typedef struct _TrackEntryListeners {
 	EventListener eventListener;
 } _TrackEntryListeners;
 
+// Listeners of disposed track entries, reused so setting track listeners doesn't allocate once warmed up. Track entries are
+// only disposed on the main thread. Never freed, as nodes may be destroyed after static destructors run.
+static vector<_TrackEntryListeners*>& getListenersPool () {
+	static vector<_TrackEntryListeners*>* pool = new vector<_TrackEntryListeners*>();
+	return *pool;
+}
+
 static _TrackEntryListeners* getListeners (spTrackEntry* entry) {
 	if (!entry->rendererObject) {
-		entry->rendererObject = NEW(spine::_TrackEntryListeners);
+		vector<_TrackEntryListeners*>& pool = getListenersPool();
+		if (pool.empty())
+			entry->rendererObject = new _TrackEntryListeners();
+		else {
+			entry->rendererObject = pool.back();
+			pool.pop_back();
+		}
 		entry->listener = trackEntryCallback;
 	}
 	return (_TrackEntryListeners*)entry->rendererObject;
 }
 
 void disposeTrackEntry (spTrackEntry* entry) {
-	if (entry->rendererObject) FREE(entry->rendererObject);
+	if (entry->rendererObject) {
+		_TrackEntryListeners* listeners = (_TrackEntryListeners*)entry->rendererObject;
+		*listeners = _TrackEntryListeners();
+		getListenersPool().push_back(listeners);
+	}
 	_spTrackEntry_dispose(entry);
 }
 
@@ -100,21 +121,21 @@ void SkeletonAnimation::initialize () {
 }
 
 SkeletonAnimation::SkeletonAnimation ()
-		: SkeletonRenderer() {
+		: SkeletonRenderer(), _fixedTimeStep(0), _accumulatedTime(0) {
 }
 
 SkeletonAnimation::SkeletonAnimation (spSkeletonData *skeletonData, bool ownsSkeletonData)
-		: SkeletonRenderer(skeletonData, ownsSkeletonData) {
+		: SkeletonRenderer(skeletonData, ownsSkeletonData), _fixedTimeStep(0), _accumulatedTime(0) {
 	initialize();
 }
 
 SkeletonAnimation::SkeletonAnimation (const std::string& skeletonDataFile, spAtlas* atlas, float scale)
-		: SkeletonRenderer(skeletonDataFile, atlas, scale) {
+		: SkeletonRenderer(skeletonDataFile, atlas, scale), _fixedTimeStep(0), _accumulatedTime(0) {
 	initialize();
 }
 
 SkeletonAnimation::SkeletonAnimation (const std::string& skeletonDataFile, const std::string& atlasFile, float scale)
-		: SkeletonRenderer(skeletonDataFile, atlasFile, scale) {
+		: SkeletonRenderer(skeletonDataFile, atlasFile, scale), _fixedTimeStep(0), _accumulatedTime(0) {
 	initialize();
 }
 
@@ -126,10 +147,23 @@ SkeletonAnimation::~SkeletonAnimation () {
 void SkeletonAnimation::update (float deltaTime) {
 	super::update(deltaTime);
 
-	deltaTime *= _timeScale;
-	spAnimationState_update(_state, deltaTime);
-	spAnimationState_apply(_state, _skeleton);
-	spSkeleton_updateWorldTransform(_skeleton);
+	if (_fixedTimeStep <= 0) {
+		spAnimationState_update(_state, deltaTime * _timeScale);
+		spAnimationState_apply(_state, _skeleton);
+		spSkeleton_updateWorldTransform(_skeleton);
+		return;
+	}
+
+	if (!_interpolator) _interpolator = spSkeletonInterpolator_create(_skeleton);
+	_accumulatedTime = min(_accumulatedTime + deltaTime, _fixedTimeStep * MAX_FIXED_STEPS);
+	while (_accumulatedTime >= _fixedTimeStep) {
+		_accumulatedTime -= _fixedTimeStep;
+		spAnimationState_update(_state, _fixedTimeStep * _timeScale);
+		spAnimationState_apply(_state, _skeleton);
+		spSkeleton_updateWorldTransform(_skeleton);
+		spSkeletonInterpolator_capture(_interpolator);
+	}
+	_interpolationAlpha = _accumulatedTime / _fixedTimeStep;
 }
 
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
@@ -251,4 +285,17 @@ spAnimationState* SkeletonAnimation::getState() const {
 	return _state;
 }
 
+void SkeletonAnimation::setFixedTimeStep (float fixedTimeStep) {
+	_fixedTimeStep = fixedTimeStep;
+	_accumulatedTime = 0;
+	if (_fixedTimeStep <= 0 && _interpolator) {
+		spSkeletonInterpolator_dispose(_interpolator);
+		_interpolator = 0;
+	}
+}
+
+float SkeletonAnimation::getFixedTimeStep () const {
+	return _fixedTimeStep;
+}
+
 }
@@ -77,6 +77,11 @@ public:
 
 	spAnimationState* getState() const;
 
+	/** When greater than 0, animations are applied at this fixed interval, in seconds, and drawing interpolates between the
+	 * two most recent poses. At most 4 steps are applied per update and any further time is dropped. */
+	void setFixedTimeStep (float fixedTimeStep);
+	float getFixedTimeStep () const;
+
 CC_CONSTRUCTOR_ACCESS:
 	SkeletonAnimation ();
 	SkeletonAnimation (spSkeletonData* skeletonData, bool ownsSkeletonData = false);
@@ -89,6 +94,8 @@ protected:
 	spAnimationState* _state;
 
 	bool _ownsAnimationStateData;
+	float _fixedTimeStep;
+	float _accumulatedTime;
 
 	StartListener _startListener;
 	EndListener _endListener;
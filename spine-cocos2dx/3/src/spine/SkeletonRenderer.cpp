@@ -32,8 +32,12 @@
 #include <spine/SkeletonRenderer.h>
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
-#include <spine/PolygonBatch.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 USING_NS_CC;
 using std::min;
@@ -41,7 +45,103 @@ using std::max;
 
 namespace spine {
 
-static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+namespace {
+
+// Renderers whose draw command was queued this frame and whose render list has not been built yet.
+std::vector<SkeletonRenderer*> pendingRenderLists;
+
+// Worker threads that build the render lists of all renderers queued in a frame, so render prep scales with the number
+// of cores. The thread that submits the draw commands takes part as well.
+class RenderListWorkers {
+public:
+	static RenderListWorkers& getInstance () {
+		static RenderListWorkers instance;
+		return instance;
+	}
+
+	/** Calls prepareRenderList for every renderer and returns when all are done. */
+	void run (const std::vector<SkeletonRenderer*>& renderers) {
+		if (_threads.empty() || renderers.size() < 2) {
+			for (auto renderer : renderers)
+				renderer->prepareRenderList();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_renderers = &renderers;
+			_next = 0;
+			_busy = (int)_threads.size();
+			++_generation;
+		}
+		_start.notify_all();
+		prepare();
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [this] { return _busy == 0; });
+		_renderers = nullptr;
+	}
+
+private:
+	RenderListWorkers () : _renderers(nullptr), _next(0), _busy(0), _generation(0), _exit(false) {
+		unsigned int count = std::thread::hardware_concurrency();
+		for (unsigned int i = 1; i < count; ++i)
+			_threads.push_back(std::thread(&RenderListWorkers::work, this));
+	}
+
+	~RenderListWorkers () {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_exit = true;
+		}
+		_start.notify_all();
+		for (auto& thread : _threads)
+			thread.join();
+	}
+
+	void prepare () {
+		int count = (int)_renderers->size();
+		for (int i = _next++; i < count; i = _next++)
+			(*_renderers)[i]->prepareRenderList();
+	}
+
+	void work () {
+		unsigned int generation = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_start.wait(lock, [&] { return _exit || _generation != generation; });
+				if (_exit) return;
+				generation = _generation;
+			}
+			prepare();
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_busy == 0) _done.notify_one();
+		}
+	}
+
+	std::vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _start, _done;
+	const std::vector<SkeletonRenderer*>* _renderers;
+	std::atomic<int> _next;
+	int _busy;
+	unsigned int _generation;
+	bool _exit;
+};
+
+// The render list splits batches before 16-bit indices overflow, but a single attachment with more vertices than 16-bit
+// indices can address can't be split. OpenGL ES only has 32-bit indices with an extension.
+bool use32BitIndices (const spSkeletonData* skeletonData) {
+	if (spSkeletonData_getMaxWorldVerticesCount(skeletonData) / 2 <= 65536) return false;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+	return true;
+#else
+	if (Configuration::getInstance()->checkForGLExtension("GL_OES_element_index_uint")) return true;
+	CCLOG("Skeleton has an attachment with more than 65536 vertices, but 32-bit indices are not supported.");
+	return false;
+#endif
+}
+
+}
 
 SkeletonRenderer* SkeletonRenderer::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonRenderer* node = new SkeletonRenderer(skeletonData, ownsSkeletonData);
@@ -62,10 +162,7 @@ SkeletonRenderer* SkeletonRenderer::createWithFile (const std::string& skeletonD
 }
 
 void SkeletonRenderer::initialize () {
-	_worldVertices = MALLOC(float, 1000); // Max number of vertices per mesh.
-
-	_batch = PolygonBatch::createWithCapacity(2000); // Max number of vertices and triangles per batch.
-	_batch->retain();
+	_renderList = spSkeletonRenderList_create(use32BitIndices(_skeleton->data));
 
 	_blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 	setOpacityModifyRGB(true);
@@ -79,21 +176,21 @@ void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsS
 }
 
 SkeletonRenderer::SkeletonRenderer ()
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _renderListQueued(false), _debugSlots(false), _debugBones(false), _timeScale(1), _interpolator(0), _interpolationAlpha(1) {
 }
 
 SkeletonRenderer::SkeletonRenderer (spSkeletonData *skeletonData, bool ownsSkeletonData)
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _renderListQueued(false), _debugSlots(false), _debugBones(false), _timeScale(1), _interpolator(0), _interpolationAlpha(1) {
 	initWithData(skeletonData, ownsSkeletonData);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, spAtlas* atlas, float scale)
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _renderListQueued(false), _debugSlots(false), _debugBones(false), _timeScale(1), _interpolator(0), _interpolationAlpha(1) {
 	initWithFile(skeletonDataFile, atlas, scale);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, const std::string& atlasFile, float scale)
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _renderListQueued(false), _debugSlots(false), _debugBones(false), _timeScale(1), _interpolator(0), _interpolationAlpha(1) {
 	initWithFile(skeletonDataFile, atlasFile, scale);
 }
 
@@ -101,8 +198,10 @@ SkeletonRenderer::~SkeletonRenderer () {
 	if (_ownsSkeletonData) spSkeletonData_dispose(_skeleton->data);
 	if (_atlas) spAtlas_dispose(_atlas);
 	spSkeleton_dispose(_skeleton);
-	_batch->release();
-	FREE(_worldVertices);
+	if (_renderListQueued)
+		pendingRenderLists.erase(std::remove(pendingRenderLists.begin(), pendingRenderLists.end(), this), pendingRenderLists.end());
+	spSkeletonRenderList_dispose(_renderList);
+	if (_interpolator) spSkeletonInterpolator_dispose(_interpolator);
 }
 
 void SkeletonRenderer::initWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
@@ -144,105 +243,104 @@ void SkeletonRenderer::update (float deltaTime) {
 }
 
 void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+#if CC_USE_CULLING
+	// Skip the skeleton when it is off screen and let the render list skip slots that are off screen. The bounds are
+	// conservative and much cheaper to compute than the vertices.
+	Director* director = Director::getInstance();
+	Rect visibleRect = RectApplyTransform(Rect(director->getVisibleOrigin(), director->getVisibleSize()), transform.getInversed());
+	// Cull with the interpolated pose that prepareRenderList draws.
+	if (_interpolator) spSkeletonInterpolator_apply(_interpolator, _interpolationAlpha);
+	float bounds[4];
+	bool visible = !spSkeleton_getBounds(_skeleton, bounds) || (bounds[2] >= visibleRect.getMinX()
+			&& bounds[0] <= visibleRect.getMaxX() && bounds[3] >= visibleRect.getMinY() && bounds[1] <= visibleRect.getMaxY());
+	if (_interpolator) spSkeletonInterpolator_restore(_interpolator);
+	if (!visible) return;
+	_renderList->cull = true;
+	_renderList->cullMinX = visibleRect.getMinX();
+	_renderList->cullMinY = visibleRect.getMinY();
+	_renderList->cullMaxX = visibleRect.getMaxX();
+	_renderList->cullMaxY = visibleRect.getMaxY();
+#endif
+
 	_drawCommand.init(_globalZOrder);
 	_drawCommand.func = CC_CALLBACK_0(SkeletonRenderer::drawSkeleton, this, transform, transformFlags);
 	renderer->addCommand(&_drawCommand);
-}
 
-void SkeletonRenderer::drawSkeleton (const Mat4 &transform, uint32_t transformFlags) {
-	getGLProgramState()->apply(transform);
+	if (!_renderListQueued) {
+		_renderListQueued = true;
+		pendingRenderLists.push_back(this);
+	}
+}
 
+void SkeletonRenderer::prepareRenderList () {
 	Color3B nodeColor = getColor();
 	_skeleton->r = nodeColor.r / (float)255;
 	_skeleton->g = nodeColor.g / (float)255;
 	_skeleton->b = nodeColor.b / (float)255;
 	_skeleton->a = getDisplayedOpacity() / (float)255;
 
+	_renderList->premultipliedAlpha = _premultipliedAlpha;
+	if (_interpolator) {
+		spSkeletonInterpolator_apply(_interpolator, _interpolationAlpha);
+		spSkeletonRenderList_update(_renderList, _skeleton);
+		spSkeletonInterpolator_restore(_interpolator);
+	} else
+		spSkeletonRenderList_update(_renderList, _skeleton);
+	_renderListQueued = false;
+}
+
+void SkeletonRenderer::drawSkeleton (const Mat4 &transform, uint32_t transformFlags) {
+	getGLProgramState()->apply(transform);
+
+	// The first skeleton drawn in a frame builds the render lists for all skeletons queued by draw, in parallel.
+	if (_renderListQueued) {
+		RenderListWorkers::getInstance().run(pendingRenderLists);
+		pendingRenderLists.clear();
+	}
+
+	if (_renderList->batchesCount) {
+		GL::bindVAO(0);
+		glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+		glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+		glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORDS);
+	}
 	int blendMode = -1;
-	Color4B color;
-	const float* uvs = nullptr;
-	int verticesCount = 0;
-	const int* triangles = nullptr;
-	int trianglesCount = 0;
-	float r = 0, g = 0, b = 0, a = 0;
-	for (int i = 0, n = _skeleton->slotsCount; i < n; i++) {
-		spSlot* slot = _skeleton->drawOrder[i];
-		if (!slot->attachment) continue;
-		Texture2D *texture = nullptr;
-		switch (slot->attachment->type) {
-		case SP_ATTACHMENT_REGION: {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = 8;
-			triangles = quadTriangles;
-			trianglesCount = 6;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_MESH: {
-			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(attachment, slot, _worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->verticesCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_SKINNED_MESH: {
-			spSkinnedMeshAttachment* attachment = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(attachment, slot, _worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->uvsCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		default: ;
-		} 
-		if (texture) {
-			if (slot->data->blendMode != blendMode) {
-				_batch->flush();
-				blendMode = slot->data->blendMode;
-				switch (slot->data->blendMode) {
-				case SP_BLEND_MODE_ADDITIVE:
-					GL::blendFunc(_premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
-					break;
-				case SP_BLEND_MODE_MULTIPLY:
-					GL::blendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
-					break;
-				case SP_BLEND_MODE_SCREEN:
-					GL::blendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-					break;
-				default:
-					GL::blendFunc(_blendFunc.src, _blendFunc.dst);
-				}
+	for (int i = 0, n = _renderList->batchesCount; i < n; i++) {
+		spRenderBatch* batch = _renderList->batches + i;
+		if (batch->blendMode != blendMode) {
+			blendMode = batch->blendMode;
+			switch (batch->blendMode) {
+			case SP_BLEND_MODE_ADDITIVE:
+				GL::blendFunc(_premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
+				break;
+			case SP_BLEND_MODE_MULTIPLY:
+				GL::blendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
+				break;
+			case SP_BLEND_MODE_SCREEN:
+				GL::blendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+				break;
+			default:
+				GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 			}
-			color.a = _skeleton->a * slot->a * a * 255;
-			float multiplier = _premultipliedAlpha ? color.a : 255;
-			color.r = _skeleton->r * slot->r * r * multiplier;
-			color.g = _skeleton->g * slot->g * g * multiplier;
-			color.b = _skeleton->b * slot->b * b * multiplier;
-			_batch->add(texture, _worldVertices, uvs, verticesCount, triangles, trianglesCount, &color);
 		}
+		GL::bindTexture2D(((Texture2D*)batch->rendererObject)->getName());
+
+		// spRenderVertex has the same layout as V2F_C4B_T2F.
+		const spRenderVertex* vertices = _renderList->vertices + batch->verticesStart;
+		glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(spRenderVertex), &vertices->x);
+		glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(spRenderVertex), &vertices->r);
+		glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, sizeof(spRenderVertex), &vertices->u);
+		if (_renderList->use32BitIndices)
+			glDrawElements(GL_TRIANGLES, batch->indicesCount, GL_UNSIGNED_INT, (GLuint*)_renderList->indices + batch->indicesStart);
+		else
+			glDrawElements(GL_TRIANGLES, batch->indicesCount, GL_UNSIGNED_SHORT, (GLushort*)_renderList->indices + batch->indicesStart);
+
+		CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, batch->verticesCount);
 	}
-	_batch->flush();
+	CHECK_GL_ERROR_DEBUG();
 
 	if (_debugSlots || _debugBones) {
+		if (_interpolator) spSkeletonInterpolator_apply(_interpolator, _interpolationAlpha);
 		Director* director = Director::getInstance();
 		director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 		director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, transform);
@@ -256,12 +354,12 @@ void SkeletonRenderer::drawSkeleton (const Mat4 &transform, uint32_t transformFl
 			for (int i = 0, n = _skeleton->slotsCount; i < n; i++) {
 				spSlot* slot = _skeleton->drawOrder[i];
 				if (!slot->attachment || slot->attachment->type != SP_ATTACHMENT_REGION) continue;
-				spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-				spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices);
-				points[0] = Vec2(_worldVertices[0], _worldVertices[1]);
-				points[1] = Vec2(_worldVertices[2], _worldVertices[3]);
-				points[2] = Vec2(_worldVertices[4], _worldVertices[5]);
-				points[3] = Vec2(_worldVertices[6], _worldVertices[7]);
+				int verticesCount;
+				const float* worldVertices = spSlot_getWorldVertices(slot, &verticesCount);
+				points[0] = Vec2(worldVertices[0], worldVertices[1]);
+				points[1] = Vec2(worldVertices[2], worldVertices[3]);
+				points[2] = Vec2(worldVertices[4], worldVertices[5]);
+				points[3] = Vec2(worldVertices[6], worldVertices[7]);
 				DrawPrimitives::drawPoly(points, 4, true);
 			}
 		}
@@ -285,44 +383,20 @@ void SkeletonRenderer::drawSkeleton (const Mat4 &transform, uint32_t transformFl
 			}
 		}
 		director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+		if (_interpolator) spSkeletonInterpolator_restore(_interpolator);
 	}
 }
 
-Texture2D* SkeletonRenderer::getTexture (spRegionAttachment* attachment) const {
-	return (Texture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
-
-Texture2D* SkeletonRenderer::getTexture (spMeshAttachment* attachment) const {
-	return (Texture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
-
-Texture2D* SkeletonRenderer::getTexture (spSkinnedMeshAttachment* attachment) const {
-	return (Texture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
-
 Rect SkeletonRenderer::getBoundingBox () const {
 	float minX = FLT_MAX, minY = FLT_MAX, maxX = FLT_MIN, maxY = FLT_MIN;
 	float scaleX = getScaleX(), scaleY = getScaleY();
 	for (int i = 0; i < _skeleton->slotsCount; ++i) {
 		spSlot* slot = _skeleton->slots[i];
-		if (!slot->attachment) continue;
+		if (!slot->attachment || slot->attachment->type == SP_ATTACHMENT_BOUNDING_BOX) continue;
 		int verticesCount;
-		if (slot->attachment->type == SP_ATTACHMENT_REGION) {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices);
-			verticesCount = 8;
-		} else if (slot->attachment->type == SP_ATTACHMENT_MESH) {
-			spMeshAttachment* mesh = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(mesh, slot, _worldVertices);
-			verticesCount = mesh->verticesCount;
-		} else if (slot->attachment->type == SP_ATTACHMENT_SKINNED_MESH) {
-			spSkinnedMeshAttachment* mesh = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(mesh, slot, _worldVertices);
-			verticesCount = mesh->uvsCount;
-		} else
-			continue;
+		const float* worldVertices = spSlot_getWorldVertices(slot, &verticesCount);
 		for (int ii = 0; ii < verticesCount; ii += 2) {
-			float x = _worldVertices[ii] * scaleX, y = _worldVertices[ii + 1] * scaleY;
+			float x = worldVertices[ii] * scaleX, y = worldVertices[ii + 1] * scaleY;
 			minX = min(minX, x);
 			minY = min(minY, y);
 			maxX = max(maxX, x);
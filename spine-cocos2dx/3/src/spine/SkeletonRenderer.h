@@ -37,8 +37,6 @@
 
 namespace spine {
 
-class PolygonBatch;
-
 /** Draws a skeleton. */
 class SkeletonRenderer: public cocos2d::Node, public cocos2d::BlendProtocol {
 public:
@@ -49,6 +47,9 @@ public:
 	virtual void update (float deltaTime) override;
 	virtual void draw (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags) override;
 	virtual void drawSkeleton (const cocos2d::Mat4& transform, uint32_t transformFlags);
+	/** Computes the vertices drawn by drawSkeleton. Render lists for all skeletons drawn in a frame are computed in parallel
+	 * when the first one is drawn, so this may be called from a worker thread. */
+	virtual void prepareRenderList ();
 	virtual cocos2d::Rect getBoundingBox () const override;
 	virtual void onEnter () override;
 	virtual void onExit () override;
@@ -113,21 +114,21 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
 	void setSkeletonData (spSkeletonData* skeletonData, bool ownsSkeletonData);
-	virtual cocos2d::Texture2D* getTexture (spRegionAttachment* attachment) const;
-	virtual cocos2d::Texture2D* getTexture (spMeshAttachment* attachment) const;
-	virtual cocos2d::Texture2D* getTexture (spSkinnedMeshAttachment* attachment) const;
 
 	bool _ownsSkeletonData;
 	spAtlas* _atlas;
 	cocos2d::CustomCommand _drawCommand;
 	cocos2d::BlendFunc _blendFunc;
-	PolygonBatch* _batch;
-	float* _worldVertices;
+	spSkeletonRenderList* _renderList;
+	bool _renderListQueued;
 	bool _premultipliedAlpha;
 	spSkeleton* _skeleton;
 	float _timeScale;
 	bool _debugSlots;
 	bool _debugBones;
+	// When not null, prepareRenderList draws the pose interpolated by _interpolationAlpha, see SkeletonAnimation::setFixedTimeStep.
+	spSkeletonInterpolator* _interpolator;
+	float _interpolationAlpha;
 };
 
 }
@@ -36,10 +36,13 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
-
-#ifndef SPINE_MESH_VERTEX_COUNT_MAX
-#define SPINE_MESH_VERTEX_COUNT_MAX 1000
-#endif
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace sf;
 
@@ -65,13 +68,20 @@ char* _Util_readFile (const char* path, int* length){
 
 namespace spine {
 
+// The most fixed steps an update applies. The time of a longer frame, eg after a stall, is dropped rather than catching up with
+// many steps that would each fire their events.
+static const int MAX_FIXED_STEPS = 4;
+
 SkeletonDrawable::SkeletonDrawable (SkeletonData* skeletonData, AnimationStateData* stateData) :
 				timeScale(1),
+				fixedTimeStep(0),
 				vertexArray(new VertexArray(Triangles, skeletonData->bonesCount * 4)),
-				worldVertices(0) {
+				interpolator(0),
+				accumulatedTime(0) {
 	Bone_setYDown(true);
-	worldVertices = MALLOC(float, SPINE_MESH_VERTEX_COUNT_MAX);
 	skeleton = Skeleton_create(skeletonData);
+	renderList = SkeletonRenderList_create(true);
+	prepared = false;
 
 	ownsAnimationStateData = stateData == 0;
 	if (ownsAnimationStateData) stateData = AnimationStateData_create(skeletonData);
@@ -81,159 +91,212 @@ SkeletonDrawable::SkeletonDrawable (SkeletonData* skeletonData, AnimationStateDa
 
 SkeletonDrawable::~SkeletonDrawable () {
 	delete vertexArray;
-	FREE(worldVertices);
+	SkeletonRenderList_dispose(renderList);
+	if (interpolator) SkeletonInterpolator_dispose(interpolator);
     if (ownsAnimationStateData) AnimationStateData_dispose(state->data);
 	AnimationState_dispose(state);
 	Skeleton_dispose(skeleton);
 }
 
 void SkeletonDrawable::update (float deltaTime) {
-	Skeleton_update(skeleton, deltaTime);
-	AnimationState_update(state, deltaTime * timeScale);
-	AnimationState_apply(state, skeleton);
-	Skeleton_updateWorldTransform(skeleton);
+	if (fixedTimeStep <= 0) {
+		if (interpolator) {
+			SkeletonInterpolator_dispose(interpolator);
+			interpolator = 0;
+		}
+		Skeleton_update(skeleton, deltaTime);
+		AnimationState_update(state, deltaTime * timeScale);
+		AnimationState_apply(state, skeleton);
+		Skeleton_updateWorldTransform(skeleton);
+		return;
+	}
+
+	if (!interpolator) {
+		interpolator = SkeletonInterpolator_create(skeleton);
+		accumulatedTime = 0;
+	}
+	accumulatedTime = std::min(accumulatedTime + deltaTime, fixedTimeStep * MAX_FIXED_STEPS);
+	while (accumulatedTime >= fixedTimeStep) {
+		accumulatedTime -= fixedTimeStep;
+		Skeleton_update(skeleton, fixedTimeStep);
+		AnimationState_update(state, fixedTimeStep * timeScale);
+		AnimationState_apply(state, skeleton);
+		Skeleton_updateWorldTransform(skeleton);
+		SkeletonInterpolator_capture(interpolator);
+	}
 }
 
-void SkeletonDrawable::draw (RenderTarget& target, RenderStates states) const {
-	vertexArray->clear();
+namespace {
+void setCullRect (SkeletonRenderList* renderList, const View& view, const Transform& transform) {
+	// The view's inverse transform maps the target's normalized coordinates to world coordinates.
+	FloatRect rect = transform.getInverse().transformRect(view.getInverseTransform().transformRect(FloatRect(-1, -1, 2, 2)));
+	renderList->cull = true;
+	renderList->cullMinX = rect.left;
+	renderList->cullMinY = rect.top;
+	renderList->cullMaxX = rect.left + rect.width;
+	renderList->cullMaxY = rect.top + rect.height;
+}
+}
 
-	sf::Vertex vertices[4];
-	sf::Vertex vertex;
-	for (int i = 0; i < skeleton->slotsCount; ++i) {
-		Slot* slot = skeleton->drawOrder[i];
-		Attachment* attachment = slot->attachment;
-		if (!attachment) continue;
+void SkeletonDrawable::prepare (const View* view, const Transform& transform) {
+	renderList->cull = view != 0;
+	if (view) setCullRect(renderList, *view, transform);
+	preparedTransform = transform;
+	buildVertices();
+	prepared = true;
+}
 
-		sf::BlendMode blend;
-		switch (slot->data->blendMode) {
-		case BLEND_MODE_ADDITIVE:
-			blend = BlendAdd;
-			break;
-		case BLEND_MODE_MULTIPLY:
-			blend = BlendMultiply;
-			break;
-		case BLEND_MODE_SCREEN: // Unsupported, fall through.
-		default:
-			blend = BlendAlpha;
+namespace {
+
+// Worker threads that prepare drawables for SkeletonDrawable::prepare. They are created on first use and kept, so
+// preparing every frame doesn't create threads. The calling thread takes part as well.
+class PrepareWorkers {
+public:
+	static PrepareWorkers& getInstance () {
+		static PrepareWorkers instance;
+		return instance;
+	}
+
+	/** Prepares the drawables using the calling thread and up to workersCount workers, and returns when all are done. */
+	void run (SkeletonDrawable** drawables, int count, int workersCount, const View* view, const Transform& transform) {
+		if (workersCount < 1 || count < 2) {
+			for (int i = 0; i < count; ++i)
+				drawables[i]->prepare(view, transform);
+			return;
 		}
-		if (states.blendMode != blend) {
-			target.draw(*vertexArray, states);
-			vertexArray->clear();
-			states.blendMode = blend;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			while ((int)_threads.size() < workersCount)
+				_threads.push_back(std::thread(&PrepareWorkers::work, this, (int)_threads.size(), _generation));
+			_drawables = drawables;
+			_count = count;
+			_view = view;
+			_transform = transform;
+			_next = 0;
+			_active = workersCount;
+			_busy = workersCount;
+			++_generation;
 		}
+		_start.notify_all();
+		prepare();
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [this] { return _busy == 0; });
+		_drawables = nullptr;
+	}
 
-		Texture* texture = 0;
-		if (attachment->type == ATTACHMENT_REGION) {
-			RegionAttachment* regionAttachment = (RegionAttachment*)attachment;
-			texture = (Texture*)((AtlasRegion*)regionAttachment->rendererObject)->page->rendererObject;
-			RegionAttachment_computeWorldVertices(regionAttachment, slot->bone, worldVertices);
-
-			Uint8 r = static_cast<Uint8>(skeleton->r * slot->r * 255);
-			Uint8 g = static_cast<Uint8>(skeleton->g * slot->g * 255);
-			Uint8 b = static_cast<Uint8>(skeleton->b * slot->b * 255);
-			Uint8 a = static_cast<Uint8>(skeleton->a * slot->a * 255);
-
-			Vector2u size = texture->getSize();
-			vertices[0].color.r = r;
-			vertices[0].color.g = g;
-			vertices[0].color.b = b;
-			vertices[0].color.a = a;
-			vertices[0].position.x = worldVertices[VERTEX_X1];
-			vertices[0].position.y = worldVertices[VERTEX_Y1];
-			vertices[0].texCoords.x = regionAttachment->uvs[VERTEX_X1] * size.x;
-			vertices[0].texCoords.y = regionAttachment->uvs[VERTEX_Y1] * size.y;
-
-			vertices[1].color.r = r;
-			vertices[1].color.g = g;
-			vertices[1].color.b = b;
-			vertices[1].color.a = a;
-			vertices[1].position.x = worldVertices[VERTEX_X2];
-			vertices[1].position.y = worldVertices[VERTEX_Y2];
-			vertices[1].texCoords.x = regionAttachment->uvs[VERTEX_X2] * size.x;
-			vertices[1].texCoords.y = regionAttachment->uvs[VERTEX_Y2] * size.y;
-
-			vertices[2].color.r = r;
-			vertices[2].color.g = g;
-			vertices[2].color.b = b;
-			vertices[2].color.a = a;
-			vertices[2].position.x = worldVertices[VERTEX_X3];
-			vertices[2].position.y = worldVertices[VERTEX_Y3];
-			vertices[2].texCoords.x = regionAttachment->uvs[VERTEX_X3] * size.x;
-			vertices[2].texCoords.y = regionAttachment->uvs[VERTEX_Y3] * size.y;
-
-			vertices[3].color.r = r;
-			vertices[3].color.g = g;
-			vertices[3].color.b = b;
-			vertices[3].color.a = a;
-			vertices[3].position.x = worldVertices[VERTEX_X4];
-			vertices[3].position.y = worldVertices[VERTEX_Y4];
-			vertices[3].texCoords.x = regionAttachment->uvs[VERTEX_X4] * size.x;
-			vertices[3].texCoords.y = regionAttachment->uvs[VERTEX_Y4] * size.y;
-
-			vertexArray->append(vertices[0]);
-			vertexArray->append(vertices[1]);
-			vertexArray->append(vertices[2]);
-			vertexArray->append(vertices[0]);
-			vertexArray->append(vertices[2]);
-			vertexArray->append(vertices[3]);
-
-		} else if (attachment->type == ATTACHMENT_MESH) {
-			MeshAttachment* mesh = (MeshAttachment*)attachment;
-			if (mesh->verticesCount > SPINE_MESH_VERTEX_COUNT_MAX) continue;
-			texture = (Texture*)((AtlasRegion*)mesh->rendererObject)->page->rendererObject;
-			MeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-
-			Uint8 r = static_cast<Uint8>(skeleton->r * slot->r * 255);
-			Uint8 g = static_cast<Uint8>(skeleton->g * slot->g * 255);
-			Uint8 b = static_cast<Uint8>(skeleton->b * slot->b * 255);
-			Uint8 a = static_cast<Uint8>(skeleton->a * slot->a * 255);
-			vertex.color.r = r;
-			vertex.color.g = g;
-			vertex.color.b = b;
-			vertex.color.a = a;
-
-			Vector2u size = texture->getSize();
-			for (int i = 0; i < mesh->trianglesCount; ++i) {
-				int index = mesh->triangles[i] << 1;
-				vertex.position.x = worldVertices[index];
-				vertex.position.y = worldVertices[index + 1];
-				vertex.texCoords.x = mesh->uvs[index] * size.x;
-				vertex.texCoords.y = mesh->uvs[index + 1] * size.y;
-				vertexArray->append(vertex);
-			}
+private:
+	PrepareWorkers () : _drawables(nullptr), _count(0), _view(nullptr), _next(0), _active(0), _busy(0), _generation(0),
+		_exit(false) {
+	}
 
-		} else if (attachment->type == ATTACHMENT_SKINNED_MESH) {
-			SkinnedMeshAttachment* mesh = (SkinnedMeshAttachment*)attachment;
-			if (mesh->uvsCount > SPINE_MESH_VERTEX_COUNT_MAX) continue;
-			texture = (Texture*)((AtlasRegion*)mesh->rendererObject)->page->rendererObject;
-			SkinnedMeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-
-			Uint8 r = static_cast<Uint8>(skeleton->r * slot->r * 255);
-			Uint8 g = static_cast<Uint8>(skeleton->g * slot->g * 255);
-			Uint8 b = static_cast<Uint8>(skeleton->b * slot->b * 255);
-			Uint8 a = static_cast<Uint8>(skeleton->a * slot->a * 255);
-			vertex.color.r = r;
-			vertex.color.g = g;
-			vertex.color.b = b;
-			vertex.color.a = a;
-
-			Vector2u size = texture->getSize();
-			for (int i = 0; i < mesh->trianglesCount; ++i) {
-				int index = mesh->triangles[i] << 1;
-				vertex.position.x = worldVertices[index];
-				vertex.position.y = worldVertices[index + 1];
-				vertex.texCoords.x = mesh->uvs[index] * size.x;
-				vertex.texCoords.y = mesh->uvs[index + 1] * size.y;
-				vertexArray->append(vertex);
+	~PrepareWorkers () {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_exit = true;
+		}
+		_start.notify_all();
+		for (auto& thread : _threads)
+			thread.join();
+	}
+
+	void prepare () {
+		for (int i = _next++; i < _count; i = _next++)
+			_drawables[i]->prepare(_view, _transform);
+	}
+
+	void work (int index, unsigned int generation) {
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_start.wait(lock, [&] { return _exit || _generation != generation; });
+				if (_exit) return;
+				generation = _generation;
+				// Workers beyond the requested count sit this run out.
+				if (index >= _active) continue;
 			}
+			prepare();
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_busy == 0) _done.notify_one();
+		}
+	}
+
+	std::vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _start, _done;
+	SkeletonDrawable** _drawables;
+	int _count;
+	const View* _view;
+	Transform _transform;
+	std::atomic<int> _next;
+	int _active, _busy;
+	unsigned int _generation;
+	bool _exit;
+};
+
+}
+
+void SkeletonDrawable::prepare (SkeletonDrawable** drawables, int count, int threadsCount, const View* view,
+		const Transform& transform) {
+	if (threadsCount > count) threadsCount = count;
+	PrepareWorkers::getInstance().run(drawables, count, threadsCount - 1, view, transform);
+}
+
+void SkeletonDrawable::buildVertices () const {
+	if (fixedTimeStep > 0 && interpolator) {
+		SkeletonInterpolator_apply(interpolator, accumulatedTime / fixedTimeStep);
+		SkeletonRenderList_update(renderList, skeleton);
+		SkeletonInterpolator_restore(interpolator);
+	} else
+		SkeletonRenderList_update(renderList, skeleton);
+
+	// SFML has no indexed drawing and uses texture coordinates in pixels. Each batch's vertices start at its indicesStart.
+	vertexArray->resize(renderList->indicesCount);
+	for (int i = 0; i < renderList->batchesCount; ++i) {
+		RenderBatch* batch = renderList->batches + i;
+		Vector2u size = ((Texture*)batch->rendererObject)->getSize();
+		const RenderVertex* vertices = renderList->vertices + batch->verticesStart;
+		const unsigned int* indices = (const unsigned int*)renderList->indices + batch->indicesStart;
+		sf::Vertex* vertex = &(*vertexArray)[batch->indicesStart];
+		for (int ii = 0; ii < batch->indicesCount; ++ii, ++vertex) {
+			const RenderVertex* renderVertex = vertices + indices[ii];
+			vertex->position.x = renderVertex->x;
+			vertex->position.y = renderVertex->y;
+			vertex->color.r = renderVertex->r;
+			vertex->color.g = renderVertex->g;
+			vertex->color.b = renderVertex->b;
+			vertex->color.a = renderVertex->a;
+			vertex->texCoords.x = renderVertex->u * size.x;
+			vertex->texCoords.y = renderVertex->v * size.y;
 		}
+	}
+}
+
+void SkeletonDrawable::draw (RenderTarget& target, RenderStates states) const {
+	// Vertices prepared with another transform may have been culled against the wrong rectangle.
+	if (!prepared || (renderList->cull
+			&& memcmp(preparedTransform.getMatrix(), states.transform.getMatrix(), 16 * sizeof(float)) != 0)) {
+		setCullRect(renderList, target.getView(), states.transform);
+		buildVertices();
+	}
+	prepared = false;
+
+	for (int i = 0; i < renderList->batchesCount; ++i) {
+		RenderBatch* batch = renderList->batches + i;
 
-		if (texture) {
-			// SMFL doesn't handle batching for us, so we'll just force a single texture per skeleton.
-			states.texture = texture;
+		switch (batch->blendMode) {
+		case BLEND_MODE_ADDITIVE:
+			states.blendMode = BlendAdd;
+			break;
+		case BLEND_MODE_MULTIPLY:
+			states.blendMode = BlendMultiply;
+			break;
+		case BLEND_MODE_SCREEN: // Unsupported, fall through.
+		default:
+			states.blendMode = BlendAlpha;
 		}
+		states.texture = (Texture*)batch->rendererObject;
+		target.draw(&(*vertexArray)[batch->indicesStart], batch->indicesCount, Triangles, states);
 	}
-	target.draw(*vertexArray, states);
 }
 
 } /* namespace spine */
@@ -36,6 +36,7 @@
 #include <spine/spine.h>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Transform.hpp>
 
 namespace spine {
 
@@ -44,6 +45,9 @@ public:
 	Skeleton* skeleton;
 	AnimationState* state;
 	float timeScale;
+	/** When greater than 0, update applies animations at this fixed interval, in seconds, and draw interpolates between the two
+	 * most recent poses. At most 4 steps are applied per update and any further time is dropped. */
+	float fixedTimeStep;
 	sf::VertexArray* vertexArray;
 
 	SkeletonDrawable (SkeletonData* skeleton, AnimationStateData* stateData = 0);
@@ -51,10 +55,29 @@ public:
 
 	void update (float deltaTime);
 
+	/** Computes the vertices for the next draw. Otherwise draw computes them itself, skipping attachments outside the target's
+	 * view. Call after the skeleton's world transform has been updated. Drawables may be prepared concurrently.
+	 * @param view If not null, attachments outside the view are skipped.
+	 * @param transform The transform the drawable will be drawn with. If it is drawn with another, draw computes the vertices
+	 *           again. */
+	void prepare (const sf::View* view = 0, const sf::Transform& transform = sf::Transform::Identity);
+
+	/** Prepares the drawables in parallel, using the calling thread and up to threadsCount - 1 worker threads, which are kept
+	 * between calls. Rendering can then submit them serially with little work per draw. Skeleton data shared by the drawables
+	 * must not be changed, eg by spSkeletonData_updateCache, until this returns. */
+	static void prepare (SkeletonDrawable** drawables, int count, int threadsCount, const sf::View* view = 0,
+			const sf::Transform& transform = sf::Transform::Identity);
+
 	virtual void draw (sf::RenderTarget& target, sf::RenderStates states) const;
 private:
 	bool ownsAnimationStateData;
-	float* worldVertices;
+	SkeletonRenderList* renderList;
+	mutable bool prepared;
+	sf::Transform preparedTransform;
+	SkeletonInterpolator* interpolator;
+	float accumulatedTime;
+
+	void buildVertices () const;
 };
 
 } /* namespace spine */